@@ -9,8 +9,8 @@
  * Arduino platform.  It is designed specifically to work with the
  * Adafruit FXOS8700 breakout: https://www.adafruit.com/products/3463
  *
- * These sensors use I2C to communicate, 2 pins (SCL+SDA) are required
- * to interface with the breakout.
+ * These sensors use I2C or SPI to communicate, 2 pins (SCL+SDA) are
+ * required to interface with the breakout over I2C.
  *
  * Adafruit invests time and resources providing this open source code,
  * please support Adafruit and open-source hardware by purchasing
@@ -35,14 +35,18 @@
 #include "Adafruit_FXOS8700.h"
 #include <limits.h>
 
-/** Macro for mg per LSB at +/- 2g sensitivity (1 LSB = 0.000244mg) */
-#define ACCEL_MG_LSB_2G (0.000244F)
-/** Macro for mg per LSB at +/- 4g sensitivity (1 LSB = 0.000488mg) */
-#define ACCEL_MG_LSB_4G (0.000488F)
-/** Macro for mg per LSB at +/- 8g sensitivity (1 LSB = 0.000976mg) */
-#define ACCEL_MG_LSB_8G (0.000976F)
-/** Macro for micro tesla (uT) per LSB (1 LSB = 0.1uT) */
-#define MAG_UT_LSB (0.1F)
+/** Sample period in microseconds in accel/mag-only modes, indexed by dr[2:0]
+    like FXOS8700_DR_HZ */
+static const uint32_t DR_periodMicros[8] = {
+    1250,   /**< dr=0b000, 800Hz */
+    2500,   /**< dr=0b001, 400Hz */
+    5000,   /**< dr=0b010, 200Hz */
+    10000,  /**< dr=0b011, 100Hz */
+    20000,  /**< dr=0b100, 50Hz */
+    80000,  /**< dr=0b101, 12.5Hz */
+    160000, /**< dr=0b110, 6.25Hz */
+    640000  /**< dr=0b111, 1.5625Hz */
+};
 
 /***************************************************************************
  PRIVATE FUNCTIONS
@@ -50,34 +54,87 @@
 
 /**************************************************************************/
 /*!
-    @brief  Initializes the hardware to a default state.
+    @brief  Converts a threshold in mg to the pulse, FFMT and transient
+            threshold register value, rounding up.
 
-    @return True if the device was successfully initialized, otherwise false.
+    @param  mg The threshold in mg.
+
+    @return The 7-bit threshold, at least 1.
 */
 /**************************************************************************/
-bool Adafruit_FXOS8700::initialize() {
-  Adafruit_BusIO_Register CTRL_REG1(i2c_dev, FXOS8700_REGISTER_CTRL_REG1);
-  Adafruit_BusIO_Register CTRL_REG2(i2c_dev, FXOS8700_REGISTER_CTRL_REG2);
-  Adafruit_BusIO_RegisterBits lnoise_bit(&CTRL_REG1, 1, 2);
-  Adafruit_BusIO_RegisterBits mods_bits(&CTRL_REG2, 2, 0);
+static uint8_t embeddedThreshold(uint16_t mg) {
+  uint32_t ths =
+      ((uint32_t)mg + FXOS8700_EMBEDDED_THS_MG - 1) / FXOS8700_EMBEDDED_THS_MG;
+  if (ths < 1)
+    ths = 1;
+  if (ths > 0x7F)
+    ths = 0x7F;
+  return ths;
+}
 
-  /* Set the full scale range of the accelerometer */
-  setAccelRange(ACCEL_RANGE_2G);
+/**************************************************************************/
+/*!
+    @brief  Scales a block of raw samples into planar x, y and z arrays.
+
+            Each axis is a separate pass writing one contiguous array
+            with a constant multiplier. Compilers vectorise that form
+            without any aliasing checks where the target has SIMD floating
+            point (e.g. Helium), and it stays a plain multiply elsewhere.
+
+    @param  raw The raw samples.
+    @param  xyz The 3 * n floats to fill in, all x values, then all y
+                values, then all z values.
+    @param  n The number of samples.
+    @param  scale The SI units per LSB.
+*/
+/**************************************************************************/
+static void convertBlock(const fxos8700RawData_t *raw, float *xyz, size_t n,
+                         float scale) {
+  float *x = xyz;
+  float *y = xyz + n;
+  float *z = xyz + 2 * n;
+
+  for (size_t i = 0; i < n; i++)
+    x[i] = raw[i].x * scale;
+  for (size_t i = 0; i < n; i++)
+    y[i] = raw[i].y * scale;
+  for (size_t i = 0; i < n; i++)
+    z[i] = raw[i].z * scale;
+}
 
-  /* Low Noise & High accelerometer OSR resolution */
-  standby(true);
-  lnoise_bit.write(0x01);
-  mods_bits.write(0x02);
-  standby(false);
+/**************************************************************************/
+/*!
+    @brief  Initializes the hardware to a default state.
 
-  /* Set in hybrid mode, jumps to reg 0x33 after reading 0x06 */
-  setSensorMode(HYBRID_MODE);
-  /* Set the output data rate to 100Hz, default */
-  setOutputDataRate(ODR_100HZ);
+    @return True if the device was successfully initialized, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::initialize() {
+  /* Reset the shadow registers to their power-on values, applyConfig()
+     then writes all of them out so the cache matches the hardware
+     whatever a previous run left configured */
+  memset(_ctrlReg, 0, sizeof(_ctrlReg));
+  memset(_mctrlReg, 0, sizeof(_mctrlReg));
+  _xyzDataCfg = 0;
+  _fSetup = 0;
+
+  /* Everything is written again below, so an earlier failure needs no
+     recovery */
+  _consecutiveFailures = 0;
+  _recoverPending = false;
+
+  /* High accelerometer OSR resolution */
+  _ctrlReg[1] = 0x02;
+
+  /* Hybrid mode (jumps to reg 0x33 after reading 0x06), +/- 2g, 100Hz,
+     low noise and the highest mag OSR (OSR = 16 @ 100Hz ODR) */
+  if (!applyConfig(FXOS8700_DEFAULT_CONFIG))
+    return false;
 
-  /* Configure the magnetometer */
-  /* Highest Over Sampling Ratio = 7 > (Over Sampling Rate = 16 @ 100Hz ODR)*/
-  setMagOversamplingRatio(MAG_OSR_7);
+  /* Disable the FIFO, applyConfig() doesn't write F_SETUP */
+  if (!writeRegister(FXOS8700_REGISTER_F_SETUP, 0x00))
+    return false;
+  _fifoMode = FIFO_MODE_DISABLED;
 
   /* Clear the raw sensor data */
   accel_raw.x = 0;
@@ -90,473 +147,3004 @@ bool Adafruit_FXOS8700::initialize() {
   return true;
 }
 
-/***************************************************************************
- CONSTRUCTOR
- ***************************************************************************/
+/**************************************************************************/
+/*!
+    @brief  Recomputes the cached accelerometer scale factors for the
+            current range and fixed-point format, so the per-sample
+            conversion is a single multiply per axis.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::updateAccelScale() {
+  float mg_lsb = ACCEL_MG_LSB_2G;
+
+  switch (_range) {
+  case (ACCEL_RANGE_2G):
+    mg_lsb = ACCEL_MG_LSB_2G;
+    break;
+  case (ACCEL_RANGE_4G):
+    mg_lsb = ACCEL_MG_LSB_4G;
+    break;
+  case (ACCEL_RANGE_8G):
+    mg_lsb = ACCEL_MG_LSB_8G;
+    break;
+  }
+
+  _accelScale = mg_lsb * SENSORS_GRAVITY_STANDARD;
+
+  /* Keep as many fractional bits in the multiplier as the int32_t product
+     allows for a full scale 14-bit sample */
+  switch (_fixedFormat) {
+  case (ACCEL_FIXED_MILLI_G):
+    _accelFixedScale = (int32_t)(mg_lsb * 1000.0F * 65536.0F + 0.5F);
+    _accelFixedShift = 16;
+    break;
+  case (ACCEL_FIXED_Q16):
+    _accelFixedScale = (int32_t)(_accelScale * 16777216.0F + 0.5F);
+    _accelFixedShift = 8;
+    break;
+  }
+}
 
 /**************************************************************************/
 /*!
-    @brief  Instantiates a new Adafruit_FXOS8700 class, including assigning
-            a unique ID to the accel and magnetometer for logging purposes.
+    @brief  Gets the shadow copy of a configuration register.
 
-    @param accelSensorID The unique ID to associate with the accelerometer.
-    @param magSensorID The unique ID to associate with the magnetometer.
+    @param  reg The register address.
+
+    @return A pointer to the cached register value, or NULL if the register
+            isn't shadowed.
 */
 /**************************************************************************/
-Adafruit_FXOS8700::Adafruit_FXOS8700(int32_t accelSensorID,
-                                     int32_t magSensorID) {
-  _accelSensorID = accelSensorID;
-  _magSensorID = magSensorID;
+uint8_t *Adafruit_FXOS8700::shadowRegister(uint8_t reg) {
+  if (reg >= FXOS8700_REGISTER_CTRL_REG1 && reg <= FXOS8700_REGISTER_CTRL_REG5)
+    return &_ctrlReg[reg - FXOS8700_REGISTER_CTRL_REG1];
+  if (reg >= FXOS8700_REGISTER_MCTRL_REG1 &&
+      reg <= FXOS8700_REGISTER_MCTRL_REG3)
+    return &_mctrlReg[reg - FXOS8700_REGISTER_MCTRL_REG1];
+  if (reg == FXOS8700_REGISTER_XYZ_DATA_CFG)
+    return &_xyzDataCfg;
+  if (reg == FXOS8700_REGISTER_F_SETUP)
+    return &_fSetup;
+  return NULL;
+}
 
-  accel_sensor = new Adafruit_FXOS8700_Accelerometer(this);
-  mag_sensor = new Adafruit_FXOS8700_Magnetometer(this);
+/**************************************************************************/
+/*!
+    @brief  Burst reads consecutive registers over I2C, SPI or the
+            transport set by begin_Transport(), retrying
+            as set by setRetryPolicy().
+
+    @param  reg The first register address.
+    @param  buffer The buffer the register values are read into.
+    @param  len The number of registers to read.
+
+    @return True if the transfer was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::readRegisters(uint8_t reg, uint8_t *buffer,
+                                      size_t len) {
+  uint32_t first = micros();
+  uint8_t attempts = 0;
+  bool ok;
+
+  do {
+#if FXOS8700_ENABLE_STATS
+    uint32_t start = micros();
+#endif
+
+    if (_transport) {
+      ok = _transport->read(reg, buffer, len);
+    } else if (spi_dev) {
+      /* R/W bit clear with ADDR[6:0], then ADDR[7] in the second byte */
+      const uint8_t cmd[] = {(uint8_t)(reg & 0x7F), (uint8_t)(reg & 0x80)};
+      ok = spi_dev->write_then_read(cmd, sizeof(cmd), buffer, len);
+    } else {
+      ok = i2c_dev->write_then_read(&reg, 1, buffer, len);
+    }
+
+#if FXOS8700_ENABLE_STATS
+    recordTransfer(spi_dev ? 2 : 1, len, micros() - start, ok);
+#endif
+  } while (!ok && retryTransfer(++attempts, first));
+
+  return completeTransfer(ok);
 }
 
-/***************************************************************************
- DESTRUCTOR
- ***************************************************************************/
-Adafruit_FXOS8700::~Adafruit_FXOS8700() {
-  if (i2c_dev)
-    delete i2c_dev;
-  if (accel_sensor)
-    delete accel_sensor;
-  if (mag_sensor)
-    delete mag_sensor;
+/**************************************************************************/
+/*!
+    @brief  Burst writes consecutive registers over I2C, SPI or the
+            transport set by begin_Transport(), retrying as set by
+            setRetryPolicy() and updating any shadow copies once the write
+            succeeded.
+
+    @param  reg The first register address.
+    @param  buffer The register values to write.
+    @param  len The number of registers to write.
+
+    @return True if the transfer was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::writeRegisters(uint8_t reg, const uint8_t *buffer,
+                                       size_t len) {
+  uint32_t first = micros();
+  uint8_t attempts = 0;
+  bool ok;
+
+  do {
+#if FXOS8700_ENABLE_STATS
+    uint32_t start = micros();
+#endif
+
+    if (_transport) {
+      ok = _transport->write(reg, buffer, len);
+    } else if (spi_dev) {
+      /* R/W bit set with ADDR[6:0], then ADDR[7] in the second byte */
+      const uint8_t cmd[] = {(uint8_t)(0x80 | (reg & 0x7F)),
+                             (uint8_t)(reg & 0x80)};
+      ok = spi_dev->write(buffer, len, cmd, sizeof(cmd));
+    } else {
+      ok = i2c_dev->write(buffer, len, true, &reg, 1);
+    }
+
+#if FXOS8700_ENABLE_STATS
+    recordTransfer(len + (spi_dev ? 2 : 1), 0, micros() - start, ok);
+#endif
+  } while (!ok && retryTransfer(++attempts, first));
+
+  /* Only a write that reached the sensor changes the shadow copies, so
+     they never hold a value the sensor didn't get */
+  for (size_t i = 0; ok && i < len; i++) {
+    uint8_t *shadow = shadowRegister(reg + i);
+    if (shadow)
+      *shadow = buffer[i];
+  }
+
+  return completeTransfer(ok);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a bus transfer to the statistics returned by getStats().
+            Does nothing unless FXOS8700_ENABLE_STATS is set.
+
+    @param  written The number of bytes written, including the register
+                    address.
+    @param  read The number of bytes read.
+    @param  elapsed The time spent in the transfer, in microseconds.
+    @param  ok Whether the transfer succeeded.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::recordTransfer(size_t written, size_t read,
+                                       uint32_t elapsed, bool ok) {
+#if FXOS8700_ENABLE_STATS
+  _stats.transactions++;
+  _stats.bytesWritten += written;
+  _stats.bytesRead += read;
+  _stats.busMicros += elapsed;
+  if (!ok)
+    _stats.failures++;
+#else
+  (void)written;
+  (void)read;
+  (void)elapsed;
+  (void)ok;
+#endif
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decides whether a failed transfer is tried again.
+
+    @param  attempts The number of tries made so far.
+    @param  first micros() when the first try started.
+
+    @return True if the retry policy allows another try, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::retryTransfer(uint8_t attempts, uint32_t first) {
+  if (attempts >= _retryPolicy.attempts)
+    return false;
+  if (_retryPolicy.deadline_us &&
+      (uint32_t)(micros() - first) >= _retryPolicy.deadline_us)
+    return false;
+
+#if FXOS8700_ENABLE_STATS
+  _stats.retries++;
+#endif
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Records the outcome of a transfer once any retries are done,
+            scheduling recover() after too many consecutive failures.
+
+            The transfer may be one step of a standby transition or a
+            setter's register sequence, so recover() isn't run here, where
+            it would clobber the standby state and then be overwritten by
+            the rest of the sequence. runPendingRecovery() runs it at the
+            start of the next read instead.
+
+    @param  ok Whether the transfer succeeded.
+
+    @return ok, so it can be returned straight from the transfer.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::completeTransfer(bool ok) {
+  if (ok) {
+    _consecutiveFailures = 0;
+    return true;
+  }
+
+  _lastError = FXOS8700_BUS_ERROR;
+
+  /* recover() does its own transfers, which mustn't start another */
+  if (_retryPolicy.recoverAfter && !_recovering &&
+      ++_consecutiveFailures >= _retryPolicy.recoverAfter)
+    _recoverPending = true;
+
+  return false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Runs the recover() scheduled by completeTransfer(), if any.
+            Only called at the start of a read, where no standby
+            transition or register sequence is in progress.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::runPendingRecovery() {
+  if (_recoverPending && !_recovering && !_standbyPending)
+    recover();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads a single register.
+
+    @param  reg The register address.
+    @param  value Set to the register value, left untouched if the
+                  transfer failed.
+
+    @return True if the transfer was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::readRegister(uint8_t reg, uint8_t *value) {
+  return readRegisters(reg, value, 1);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes a single register, updating its shadow copy.
+
+    @param  reg The register address.
+    @param  value The value to write.
+
+    @return True if the transfer was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::writeRegister(uint8_t reg, uint8_t value) {
+  return writeRegisters(reg, &value, 1);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes a bit field within a register.
+
+            Shadowed registers are updated from their cached value with a
+            single write, other registers fall back to read-modify-write.
+            Nothing is written if that read fails.
+
+    @param  reg The register address.
+    @param  bits The width of the bit field.
+    @param  shift The position of the field's least significant bit.
+    @param  value The new field value.
+
+    @return True if the transfer was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::writeBits(uint8_t reg, uint8_t bits, uint8_t shift,
+                                  uint8_t value) {
+  uint8_t *shadow = shadowRegister(reg);
+  uint8_t current;
+  if (shadow)
+    current = *shadow;
+  else if (!readRegister(reg, &current))
+    return false;
+
+  uint8_t mask = ((1 << bits) - 1) << shift;
+
+  return writeRegister(reg, (current & ~mask) | ((value << shift) & mask));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Enables or disables an accelerometer interrupt source and
+            routes it to an interrupt pin, in one CTRL_REG4/CTRL_REG5
+            burst.
+
+    @param  source The fxos8700InterruptSource_t bit.
+    @param  enable Set to true to enable the interrupt.
+    @param  intPin The interrupt pin (INT1 or INT2) to route it to.
+
+    @return True if the transfer was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::routeInterrupt(uint8_t source, bool enable,
+                                       fxos8700InterruptPin_t intPin) {
+  uint8_t ctrl[2] = {_ctrlReg[3], _ctrlReg[4]};
+
+  ctrl[0] = enable ? (ctrl[0] | source) : (ctrl[0] & ~source);
+  ctrl[1] = (intPin == INT_PIN_1) ? (ctrl[1] | source) : (ctrl[1] & ~source);
+
+  if (!writeRegisters(FXOS8700_REGISTER_CTRL_REG4, ctrl, sizeof(ctrl)))
+    return false;
+
+  /* The caller owns this enable now, disableAutoSleep() leaves it alone */
+  _sleepIntEnables &= ~source;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Looks up the aslp_rate[1:0] setting for a sleep ODR.
+
+    @param  rate The output data rate while asleep.
+    @param  aslpRate Set to the aslp_rate[1:0] value.
+
+    @return True if the rate is one of the auto-sleep rates for the current
+            mode, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::lookupSleepRate(fxos8700ODR_t rate,
+                                        uint8_t *aslpRate) {
+  /* aslp_rate[1:0] can only select the four slowest dr settings */
+  uint8_t odr;
+  if (!lookupOutputDataRate(_mode, rate, &odr) || odr < 0x20)
+    return false;
+
+  *aslpRate = (odr >> 3) - 4;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes the auto-sleep configuration, the sensor has to be in
+            standby.
+
+    @param  config The auto-sleep settings.
+    @param  aslpRate The aslp_rate[1:0] value for config.sleepRate.
+
+    @return True if every transfer was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::writeAutoSleep(const fxos8700AutoSleepConfig_t &config,
+                                       uint8_t aslpRate) {
+  /* Round up, and keep at least one step */
+  uint32_t count = (config.sleepDelay + FXOS8700_ASLP_COUNT_MS - 1) /
+                   FXOS8700_ASLP_COUNT_MS;
+  if (count < 1)
+    count = 1;
+  if (count > 0xFF)
+    count = 0xFF;
+
+  /* smods[1:0] and slpe, in CTRL_REG2 */
+  uint8_t ctrl[3] = {_ctrlReg[1], _ctrlReg[2], _ctrlReg[3]};
+  ctrl[0] = (ctrl[0] & ~0x18) | (config.sleepMode << 3) | 0x04;
+
+  /* A function only wakes the sensor with its interrupt enabled. The
+     int_en bits in CTRL_REG4 sit one bit below the wake bits, and the
+     ones that weren't already on are cleared again by clearAutoSleep() */
+  uint8_t wake = config.wakeSources & WAKE_SOURCE_ALL;
+  uint8_t intEnables = wake >> 1;
+  ctrl[1] = (ctrl[1] & ~WAKE_SOURCE_ALL) | wake;
+  ctrl[2] &= ~_sleepIntEnables;
+  uint8_t sleepIntEnables = intEnables & ~ctrl[2];
+  ctrl[2] |= intEnables;
+
+  /* m_aslp_os[2:0] */
+  uint8_t mctrl_reg3 = (_mctrlReg[2] & ~0x70) | (config.sleepRatio << 4);
+
+  if (!writeRegister(FXOS8700_REGISTER_ASLP_COUNT, count) ||
+      !writeRegisters(FXOS8700_REGISTER_CTRL_REG2, ctrl, sizeof(ctrl)))
+    return false;
+  _sleepIntEnables = sleepIntEnables;
+  if (!writeRegister(FXOS8700_REGISTER_MCTRL_REG3, mctrl_reg3))
+    return false;
+
+  /* aslp_rate[1:0], written with the active bit by standby(false) */
+  _ctrlReg[0] = (_ctrlReg[0] & ~0xC0) | (aslpRate << 6);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Turns auto-sleep off, the sensor has to be in standby.
+
+    @return True if the transfer was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::clearAutoSleep() {
+  const uint8_t ctrl[3] = {(uint8_t)(_ctrlReg[1] & ~(0x18 | 0x04)),
+                           (uint8_t)(_ctrlReg[2] & ~WAKE_SOURCE_ALL),
+                           (uint8_t)(_ctrlReg[3] & ~_sleepIntEnables)};
+
+  if (!writeRegisters(FXOS8700_REGISTER_CTRL_REG2, ctrl, sizeof(ctrl)))
+    return false;
+  _sleepIntEnables = 0;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Looks up the dr[2:0] bits for an output data rate in
+            FXOS8700_ODR_DR_BITS.
+
+    @param  mode The sensor mode the rate applies to.
+    @param  rate The requested output data rate.
+    @param  odr Set to the dr[2:0] value, shifted into its CTRL_REG1
+                position, if the rate is available.
+
+    @return True if the rate is available in the given mode, otherwise
+            false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::lookupOutputDataRate(fxos8700SensorMode_t mode,
+                                             fxos8700ODR_t rate,
+                                             uint8_t *odr) {
+  if ((size_t)rate >= sizeof(FXOS8700_ODR_DR_BITS[0]))
+    return false;
+
+  uint8_t bits = FXOS8700_ODR_DR_BITS[mode == HYBRID_MODE][rate];
+  if (bits == FXOS8700_ODR_UNSUPPORTED)
+    return false;
+
+  *odr = bits;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads new samples into accel_raw/mag_raw and records when they
+            were taken.
+
+            If every sensor enabled in the current mode was read, the
+            samples are cached for the split Adafruit_Sensor objects, see
+            getCachedEvent().
+
+    @param  accel Set to true to read the accelerometer.
+    @param  mag Set to true to read the magnetometer.
+
+    @return True if the read was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::updateRaw(bool accel, bool mag) {
+  _sampleCached = false;
+
+  if (!readRaw(accel ? &accel_raw : NULL, mag ? &mag_raw : NULL))
+    return false;
+
+  _sampleMicros = micros();
+  _sampleTime = timestamp();
+  recordSampleInterval(_sampleMicros);
+  _sampleCached = (accel || _mode == MAG_ONLY_MODE) &&
+                  (mag || _mode == ACCEL_ONLY_MODE);
+
+  return true;
 }
 
-/***************************************************************************
- PUBLIC FUNCTIONS
- ***************************************************************************/
+/**************************************************************************/
+/*!
+    @brief  Fills in sensor events from accel_raw/mag_raw.
+
+            The event for a sensor disabled in the current mode is left
+            untouched, since the burst didn't refresh its counts.
+
+    @param    accelEvent
+              The accelerometer event to fill in, or NULL.
+    @param    magEvent
+              The magnetometer event to fill in, or NULL.
+    @param    timestamp
+              The timestamp to set on both events.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::fillEvents(sensors_event_t *accelEvent,
+                                   sensors_event_t *magEvent,
+                                   uint32_t timestamp) {
+  if (_mode == MAG_ONLY_MODE)
+    accelEvent = NULL;
+  if (_mode == ACCEL_ONLY_MODE)
+    magEvent = NULL;
+
+  if (accelEvent) {
+    /* Clear the event */
+    memset(accelEvent, 0, sizeof(sensors_event_t));
+
+    /* Set the static metadata */
+    accelEvent->version = sizeof(sensors_event_t);
+    accelEvent->sensor_id = _accelSensorID;
+    accelEvent->type = SENSOR_TYPE_ACCELEROMETER;
+
+    /* Set the timestamps */
+    accelEvent->timestamp = timestamp;
+
+    accelEvent->acceleration.x = accel_raw.x;
+    accelEvent->acceleration.y = accel_raw.y;
+    accelEvent->acceleration.z = accel_raw.z;
+
+    /* Convert accel values to m/s^2 */
+    accelEvent->acceleration.x *= _accelScale;
+    accelEvent->acceleration.y *= _accelScale;
+    accelEvent->acceleration.z *= _accelScale;
+  }
+
+  if (magEvent) {
+    memset(magEvent, 0, sizeof(sensors_event_t));
+
+    magEvent->version = sizeof(sensors_event_t);
+    magEvent->sensor_id = _magSensorID;
+    magEvent->type = SENSOR_TYPE_MAGNETIC_FIELD;
+
+    magEvent->timestamp = timestamp;
+
+    magEvent->magnetic.x = mag_raw.x;
+    magEvent->magnetic.y = mag_raw.y;
+    magEvent->magnetic.z = mag_raw.z;
+
+    /* Convert mag values to uTesla */
+    magEvent->magnetic.x *= MAG_UT_LSB;
+    magEvent->magnetic.y *= MAG_UT_LSB;
+    magEvent->magnetic.z *= MAG_UT_LSB;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks whether an event was asked for a sensor that is enabled
+            in the current mode.
+
+    @param    accelEvent
+              The accelerometer event to fill in, or NULL.
+    @param    magEvent
+              The magnetometer event to fill in, or NULL.
+
+    @return True if there is an event to fill in, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::hasEnabledEvent(const sensors_event_t *accelEvent,
+                                        const sensors_event_t *magEvent) {
+  return (accelEvent && _mode != MAG_ONLY_MODE) ||
+         (magEvent && _mode != ACCEL_ONLY_MODE);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets sensor events for the split Adafruit_Sensor objects.
+
+            The first call reads every sensor enabled in the current mode
+            in one burst. Calls for either sensor within the following
+            sample period are served from that burst, so an accelerometer
+            event followed by a magnetometer event costs one transaction
+            and both come from the same instant. The sample period is the
+            one in effect on the sensor, see getOutputDataRateHz().
+
+    @param    accelEvent
+              The accelerometer event to fill in, or NULL.
+    @param    magEvent
+              The magnetometer event to fill in, or NULL.
+
+    @return True if the event read was successful, false if it failed or
+            only sensors disabled in the current mode were asked for.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::getCachedEvent(sensors_event_t *accelEvent,
+                                       sensors_event_t *magEvent) {
+  if (!hasEnabledEvent(accelEvent, magEvent))
+    return false;
+
+  /* The period in effect, from the dr[2:0] bits written to the sensor, see
+     getOutputDataRateHz() */
+  uint32_t period = DR_periodMicros[(_ctrlReg[0] >> 3) & 0x07];
+  if (_mode == HYBRID_MODE)
+    period *= 2;
+
+  if (!_sampleCached || (uint32_t)(micros() - _sampleMicros) >= period) {
+    if (!updateRaw(true, true))
+      return false;
+  }
+
+  fillEvents(accelEvent, magEvent, _sampleTime);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads and decodes the burst that covers the requested sensors.
+
+    @param  accel The struct to decode the accelerometer into, or NULL.
+    @param  mag The struct to decode the magnetometer into, or NULL.
+    @param  status Set to the status byte at the start of the burst.
+
+    @return True if the read was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::readBurst(fxos8700RawData_t *accel,
+                                  fxos8700RawData_t *mag, uint8_t *status) {
+  uint8_t buffer[13];
+  bool readAccel = accel != NULL;
+  bool readMag = mag != NULL;
+  uint8_t reg, len;
+
+  runPendingRecovery();
+  planBurst(&readAccel, &readMag, &reg, &len);
+  if (len == 0) {
+    *status = 0;
+    return true;
+  }
+
+  if (!readRegisters(reg, buffer, len))
+    return false;
+
+  *status = buffer[0];
+  decodeBurst(buffer, readAccel ? accel : NULL, readMag ? mag : NULL);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Works out the burst read that covers the requested sensors.
+
+            Sensors that are disabled in the current mode are dropped. Both
+            sensors read 13 bytes from STATUS, since the hybrid mode
+            auto-increment jumps to reg 0x33 after reading 0x06. The
+            accelerometer alone reads 7 bytes from STATUS, the magnetometer
+            alone reads 7 bytes from M_DR_STATUS.
+
+    @param  accel Set to true to read the accelerometer, cleared if it is
+                  disabled in the current mode.
+    @param  mag Set to true to read the magnetometer, cleared if it is
+                disabled in the current mode.
+    @param  reg Set to the register the burst starts at.
+    @param  len Set to the length of the burst, 0 if there's nothing to
+                read.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::planBurst(bool *accel, bool *mag, uint8_t *reg,
+                                  uint8_t *len) {
+  if (_mode == MAG_ONLY_MODE)
+    *accel = false;
+  if (_mode == ACCEL_ONLY_MODE)
+    *mag = false;
+
+  *reg = *accel ? FXOS8700_REGISTER_STATUS : FXOS8700_REGISTER_MSTATUS;
+  *len = (*accel && *mag) ? 13 : ((*accel || *mag) ? 7 : 0);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decodes a burst read set up by planBurst().
+
+    @param  buffer The bytes read, starting with the status byte.
+    @param  accel The struct to decode the accelerometer into, or NULL if
+                  the burst doesn't cover it.
+    @param  mag The struct to decode the magnetometer into, or NULL if the
+                burst doesn't cover it.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::decodeBurst(const uint8_t *buffer,
+                                    fxos8700RawData_t *accel,
+                                    fxos8700RawData_t *mag) {
+  if (accel)
+    fxos8700DecodeAccel(&buffer[1], accel);
+  if (mag)
+    fxos8700DecodeMag(&buffer[accel ? 7 : 1], mag);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the clock selected with setTimestampSource().
+
+    @return The current time for sensor event timestamps.
+*/
+/**************************************************************************/
+uint32_t Adafruit_FXOS8700::timestamp() {
+  switch (_timestampSource) {
+  case (TIMESTAMP_MICROS):
+    return micros();
+  case (TIMESTAMP_CUSTOM):
+    return _timestampClock();
+  default:
+    return millis();
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds the interval since the previous sample to the running
+            statistics returned by getIntervalStats().
+
+    @param  now micros() when the new sample was read.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::recordSampleInterval(uint32_t now) {
+  if (_intervalStarted) {
+    uint32_t interval = now - _intervalLast;
+
+    if (_intervalCount == 0 || interval < _intervalMin)
+      _intervalMin = interval;
+    if (interval > _intervalMax)
+      _intervalMax = interval;
+    _intervalTotal += interval;
+    _intervalCount++;
+  }
+
+  _intervalLast = now;
+  _intervalStarted = true;
+}
+
+/***************************************************************************
+ CONSTRUCTOR
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates a new Adafruit_FXOS8700 class, including assigning
+            a unique ID to the accel and magnetometer for logging purposes.
+
+    @param accelSensorID The unique ID to associate with the accelerometer.
+    @param magSensorID The unique ID to associate with the magnetometer.
+*/
+/**************************************************************************/
+Adafruit_FXOS8700::Adafruit_FXOS8700(int32_t accelSensorID,
+                                     int32_t magSensorID) {
+  _accelSensorID = accelSensorID;
+  _magSensorID = magSensorID;
+  updateAccelScale();
+
+  accel_sensor = new Adafruit_FXOS8700_Accelerometer(this);
+  mag_sensor = new Adafruit_FXOS8700_Magnetometer(this);
+}
+
+/***************************************************************************
+ DESTRUCTOR
+ ***************************************************************************/
+Adafruit_FXOS8700::~Adafruit_FXOS8700() {
+  if (i2c_dev)
+    delete i2c_dev;
+  if (spi_dev)
+    delete spi_dev;
+  if (accel_sensor)
+    delete accel_sensor;
+  if (mag_sensor)
+    delete mag_sensor;
+}
+
+/***************************************************************************
+ PUBLIC FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Initializes the hardware.
+
+    @param  addr I2C address for the device.
+    @param  wire Pointer to Wire instance
+
+    @return True if the device was successfully initialized, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::begin(uint8_t addr, TwoWire *wire) {
+  if (spi_dev) {
+    delete spi_dev;
+    spi_dev = NULL;
+  }
+  if (i2c_dev)
+    delete i2c_dev;
+  _transport = NULL;
+  i2c_dev = new Adafruit_I2CDevice(addr, wire);
+  if (!i2c_dev->begin())
+    return false;
+
+  uint8_t id;
+  if (!readRegister(FXOS8700_REGISTER_WHO_AM_I, &id) || id != FXOS8700_ID)
+    return false;
+
+  return initialize();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Initializes the hardware over SPI.
+
+            Every register access, including the burst reads behind
+            getEvent(), then goes over SPI using the FXOS8700's two byte
+            command format.
+
+    @param  cs_pin The chip select pin.
+    @param  theSPI Pointer to the SPI instance.
+    @param  frequency The SPI clock in Hz, at most FXOS8700_SPI_MAX_FREQ.
+
+    @return True if the device was successfully initialized, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::begin_SPI(uint8_t cs_pin, SPIClass *theSPI,
+                                  uint32_t frequency) {
+  if (i2c_dev) {
+    delete i2c_dev;
+    i2c_dev = NULL;
+  }
+  if (spi_dev)
+    delete spi_dev;
+  _transport = NULL;
+  spi_dev = new Adafruit_SPIDevice(cs_pin, frequency, SPI_BITORDER_MSBFIRST,
+                                   SPI_MODE0, theSPI);
+  if (!spi_dev->begin())
+    return false;
+
+  uint8_t id;
+  if (!readRegister(FXOS8700_REGISTER_WHO_AM_I, &id) || id != FXOS8700_ID)
+    return false;
+
+  return initialize();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Initializes the sensor through a register transport instead of
+            the I2C or SPI bus, e.g. an Adafruit_FXOS8700_Mock.
+
+    @param  transport The transport every register access goes through.
+                      It is not copied, so it has to outlive this object.
+
+    @return True if the device was successfully initialized, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::begin_Transport(
+    Adafruit_FXOS8700_Transport *transport) {
+  if (i2c_dev) {
+    delete i2c_dev;
+    i2c_dev = NULL;
+  }
+  if (spi_dev) {
+    delete spi_dev;
+    spi_dev = NULL;
+  }
+  _transport = transport;
+  if (!_transport || !_transport->begin())
+    return false;
+
+  uint8_t id;
+  if (!readRegister(FXOS8700_REGISTER_WHO_AM_I, &id) || id != FXOS8700_ID)
+    return false;
+
+  return initialize();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the most recent sensor events.
+
+            This function reads from both the accelerometer and the
+            magnetometer in one call, and is a deviation from the standard
+            Adafruit_Sensor API, but is provided as a convenience since most
+            AHRS algorithms require sensor samples to be as close in time as
+            possible.
+
+            An event for a sensor disabled in the current mode is left
+            untouched, like the raw structs in readRaw(), so accelEvent is
+            ignored in mag-only mode and magEvent in accel-only mode.
+
+    @param    accelEvent
+              A reference to the sensors_event_t instances where the
+              accelerometer data should be written, or NULL.
+    @param    magEvent
+              A reference to the sensors_event_t instances where the
+              magnetometer data should be written, or NULL.
+
+    @return True if the event read was successful, false if it failed or
+            only sensors disabled in the current mode were asked for.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::getEvent(sensors_event_t *accelEvent,
+                                 sensors_event_t *magEvent) {
+  if (!hasEnabledEvent(accelEvent, magEvent))
+    return false;
+
+  if (!updateRaw(accelEvent != NULL, magEvent != NULL))
+    return false;
+
+  fillEvents(accelEvent, magEvent, _sampleTime);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the most recent raw sensor samples.
+
+            This is a fast path that decodes the burst read straight into
+            the caller's integer structs, skipping the sensors_event_t
+            metadata and the floating point unit conversion.
+
+            The burst only covers what was asked for and is enabled in the
+            current mode: 13 bytes from STATUS for both sensors in hybrid
+            mode, 7 bytes from STATUS for the accelerometer alone, or 7
+            bytes from M_DR_STATUS for the magnetometer alone. Structs for
+            a sensor disabled in the current mode are left untouched, and
+            getEvent() treats events the same way.
+
+    @param    accel
+              A pointer to the fxos8700RawData_t where the raw accelerometer
+              counts should be written, or NULL.
+    @param    mag
+              A pointer to the fxos8700RawData_t where the raw magnetometer
+              counts should be written, or NULL.
+
+    @return True if the read was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::readRaw(fxos8700RawData_t *accel,
+                                fxos8700RawData_t *mag) {
+  uint8_t status;
+  return readBurst(accel, mag, &status);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads a timestamped raw sample of every sensor enabled in the
+            current mode, including the status byte so missed samples can
+            be detected.
+
+    @param    sample
+              The fxos8700Sample_t to fill in. The struct for a sensor that
+              is disabled in the current mode is zeroed.
+
+    @return True if the read was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::readSample(fxos8700Sample_t *sample) {
+  if (_mode == MAG_ONLY_MODE)
+    memset(&sample->accel, 0, sizeof(sample->accel));
+  if (_mode == ACCEL_ONLY_MODE)
+    memset(&sample->mag, 0, sizeof(sample->mag));
+
+  if (!readBurst(&sample->accel, &sample->mag, &sample->status))
+    return false;
+
+  sample->timestamp = micros();
+  recordSampleInterval(sample->timestamp);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the most recent accelerometer sample in the fixed-point
+            format set with setAccelFixedFormat().
+
+    @param    accel
+              A pointer to the fxos8700FixedData_t where the converted
+              accelerometer values should be written.
+
+    @return True if the read was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::readAccelFixed(fxos8700FixedData_t *accel) {
+  if (!updateRaw(true, false))
+    return false;
+
+  convertAccelFixed(&accel_raw, accel);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Converts a raw accelerometer sample to the fixed-point format
+            set with setAccelFixedFormat(), using integer math only.
+
+    @param    raw
+              The raw accelerometer sample to convert, for example one
+              returned by readFifo().
+    @param    out
+              A pointer to the fxos8700FixedData_t where the converted
+              values should be written.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::convertAccelFixed(const fxos8700RawData_t *raw,
+                                          fxos8700FixedData_t *out) {
+  out->x = ((int32_t)raw->x * _accelFixedScale) >> _accelFixedShift;
+  out->y = ((int32_t)raw->y * _accelFixedScale) >> _accelFixedShift;
+  out->z = ((int32_t)raw->z * _accelFixedScale) >> _accelFixedShift;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Converts a block of raw accelerometer samples, such as a
+            readFifo() batch, to m/s^2 at the current range.
+
+            The output is planar (struct of arrays) so DSP code can take
+            each axis as a contiguous array. The scale is looked up once
+            for the block, and the loop is left to the compiler to
+            vectorise rather than using CMSIS-DSP or ESP-DSP, which aren't
+            available on every core this library builds for.
+
+    @param    raw
+              The raw accelerometer samples to convert.
+    @param    xyz
+              The 3 * n floats to fill in, all x values, then all y
+              values, then all z values.
+    @param    n
+              The number of samples.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::convertAccel(const fxos8700RawData_t *raw, float *xyz,
+                                     size_t n) {
+  convertBlock(raw, xyz, n, _accelScale);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Converts a block of raw magnetometer samples to uT, in the
+            same planar layout as convertAccel().
+
+    @param    raw
+              The raw magnetometer samples to convert.
+    @param    xyz
+              The 3 * n floats to fill in, all x values, then all y
+              values, then all z values.
+    @param    n
+              The number of samples.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::convertMag(const fxos8700RawData_t *raw, float *xyz,
+                                   size_t n) {
+  convertBlock(raw, xyz, n, MAG_UT_LSB);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the bus usage statistics.
+
+    @attention
+
+    The counters are only maintained when the library is built with
+    FXOS8700_ENABLE_STATS set to 1, otherwise they always read 0.
+
+    @param  stats The fxos8700Stats_t to fill in.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::getStats(fxos8700Stats_t *stats) {
+#if FXOS8700_ENABLE_STATS
+  *stats = _stats;
+#else
+  memset(stats, 0, sizeof(fxos8700Stats_t));
+#endif
+}
+
+/**************************************************************************/
+/*!
+    @brief  Resets the bus usage statistics.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::resetStats() {
+#if FXOS8700_ENABLE_STATS
+  memset(&_stats, 0, sizeof(_stats));
+#endif
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets how failed bus transfers are retried, and after how many
+            consecutive failures recover() is called automatically. The
+            automatic recover() runs at the start of the next read, e.g.
+            readSample() or getEvent(), never in the middle of a setter.
+
+    @attention
+
+    Retries run inside the blocking transfer, so attempts and
+    deadline_us bound how long a single register access can take.
+
+    @param  policy The retry policy to use.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::setRetryPolicy(const fxos8700RetryPolicy_t &policy) {
+  _retryPolicy = policy;
+  if (_retryPolicy.attempts < 1)
+    _retryPolicy.attempts = 1;
+  _consecutiveFailures = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the retry policy set with setRetryPolicy().
+
+    @param  policy The fxos8700RetryPolicy_t to copy the policy into.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::getRetryPolicy(fxos8700RetryPolicy_t *policy) {
+  *policy = _retryPolicy;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the most recent error, and clears it.
+
+            Calls that only return a bool or a value, such as getEvent()
+            or getFifoCount(), have no other way to report whether a
+            transfer failed or a standby transition timed out.
+
+    @return The most recent error since the last call, or FXOS8700_OK if
+            there was none.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::getLastError() {
+  fxos8700Status_t error = _lastError;
+  _lastError = FXOS8700_OK;
+  return error;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Restarts the bus interface and rewrites the configuration held
+            in the shadow registers.
+
+            This brings the sensor back to the configured mode, range, ODR,
+            FIFO, interrupt and auto-sleep settings after a bus lockup or
+            a brown-out of the sensor, without going back to the defaults
+            like begin() would. The embedded function thresholds, the
+            high-pass cutoff, ASLP_COUNT and the offset registers aren't
+            shadowed, so set them again if the sensor itself was reset.
+
+    @return True if the configuration was restored, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::recover() {
+  if (_recovering)
+    return false;
+  _recovering = true;
+
+#if FXOS8700_ENABLE_STATS
+  _stats.recoveries++;
+#endif
+
+  /* standby() clears the active bit and the F_SETUP writes go through the
+     shadow, so keep what has to be restored */
+  bool active = _ctrlReg[0] & 0x01;
+  uint8_t fSetup = _fSetup;
+
+  bool ok;
+  if (_transport)
+    ok = _transport->begin();
+  else if (spi_dev)
+    ok = spi_dev->begin();
+  else
+    ok = i2c_dev && i2c_dev->begin();
+  ok = ok && standby(true) &&
+       writeRegister(FXOS8700_REGISTER_XYZ_DATA_CFG, _xyzDataCfg) &&
+       writeRegister(FXOS8700_REGISTER_F_SETUP, 0x00) &&
+       writeRegister(FXOS8700_REGISTER_F_SETUP, fSetup) &&
+       writeRegisters(FXOS8700_REGISTER_CTRL_REG2, &_ctrlReg[1],
+                      sizeof(_ctrlReg) - 1) &&
+       writeRegisters(FXOS8700_REGISTER_MCTRL_REG1, _mctrlReg,
+                      sizeof(_mctrlReg));
+  if (ok && active)
+    ok = standby(false);
+
+  _fSetup = fSetup;
+  _sampleCached = false;
+  _consecutiveFailures = 0;
+  _recoverPending = false;
+  _recovering = false;
+
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the hooks used by startRead() for a non-blocking transfer,
+            for example one driven by DMA. The hooks are only used over
+            I2C, after begin_SPI() or begin_Transport() startRead()
+            always reads blocking.
+
+    @param  transport The transport hooks, or NULL to fall back to a
+                      blocking read inside startRead(). The struct must
+                      stay valid while it is in use.
+
+    @return True if the hooks were set, false if a transfer started by
+            startRead() is still in progress on the current hooks. Wait
+            for isReadComplete() before changing them.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::setAsyncTransport(
+    const fxos8700AsyncTransport_t *transport) {
+  /* isReadComplete() polls the hooks the transfer was started on */
+  if (_asyncStatus == FXOS8700_PENDING)
+    return false;
+
+  _asyncTransport = transport;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts reading every sensor enabled in the current mode without
+            waiting for the transfer. Poll isReadComplete(), then collect
+            the samples with finishRead().
+
+            Without transport hooks the read is done right away, so
+            finishRead() can be called immediately.
+
+    @return True if the transfer was started, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::startRead() {
+  if (_asyncStatus == FXOS8700_PENDING)
+    return false;
+
+  runPendingRecovery();
+  _asyncAccel = true;
+  _asyncMag = true;
+  planBurst(&_asyncAccel, &_asyncMag, &_asyncReg, &_asyncLen);
+  _asyncMicros = micros();
+  _asyncTime = timestamp();
+  _asyncUnread = true;
+
+  /* The transport hooks address an I2C device, other buses read blocking */
+  if (!_asyncTransport || !i2c_dev) {
+    _asyncStatus = readRegisters(_asyncReg, _asyncBuffer, _asyncLen)
+                       ? FXOS8700_OK
+                       : FXOS8700_BUS_ERROR;
+    return _asyncStatus == FXOS8700_OK;
+  }
+
+  if (!_asyncTransport->startRead(_asyncTransport->context,
+                                  i2c_dev->address(), _asyncReg,
+                                  _asyncBuffer, _asyncLen)) {
+    recordTransfer(0, 0, 0, false);
+    completeTransfer(false);
+    _asyncStatus = FXOS8700_BUS_ERROR;
+    return false;
+  }
+
+  _asyncStatus = FXOS8700_PENDING;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks whether the transfer started by startRead() is done.
+
+    @return True once the transfer has finished (successfully or not),
+            false while it is still in progress.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::isReadComplete() {
+  if (_asyncStatus == FXOS8700_PENDING) {
+    _asyncStatus = _asyncTransport->poll(_asyncTransport->context);
+
+    /* The CPU isn't blocked during the transfer, so no bus time is
+       counted */
+    if (_asyncStatus != FXOS8700_PENDING) {
+      recordTransfer(1, _asyncLen, 0, _asyncStatus == FXOS8700_OK);
+      completeTransfer(_asyncStatus == FXOS8700_OK);
+    }
+  }
+
+  return _asyncStatus != FXOS8700_PENDING;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decodes the transfer started by startRead() into sensor events.
+
+            accel_raw/mag_raw and the sample cache used by the split
+            Adafruit_Sensor objects are updated as well.
+
+    @param    accelEvent
+              The accelerometer event to fill in, or NULL.
+    @param    magEvent
+              The magnetometer event to fill in, or NULL.
+
+    @return True if the transfer completed successfully, false if it is
+            still in progress, failed or was never started.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::finishRead(sensors_event_t *accelEvent,
+                                   sensors_event_t *magEvent) {
+  if (!isReadComplete() || _asyncStatus != FXOS8700_OK || !_asyncUnread)
+    return false;
+
+  /* Only decode a finished burst once */
+  _asyncUnread = false;
+
+  decodeBurst(_asyncBuffer, _asyncAccel ? &accel_raw : NULL,
+              _asyncMag ? &mag_raw : NULL);
+  _sampleMicros = _asyncMicros;
+  _sampleTime = _asyncTime;
+  recordSampleInterval(_sampleMicros);
+  _sampleCached = true;
+
+  fillEvents(accelEvent, magEvent, _sampleTime);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Selects the clock used for sensor event timestamps.
+
+            The Adafruit_Sensor convention is millis(), which repeats or
+            jumps by 1-2 ms at high ODRs. micros() or a custom clock give
+            integration filters a usable time base.
+
+    @param  source The clock to use. TIMESTAMP_CUSTOM is only accepted
+                   once a clock has been set with setTimestampClock().
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::setTimestampSource(fxos8700TimestampSource_t source) {
+  if (source == TIMESTAMP_CUSTOM && !_timestampClock)
+    return;
+
+  _timestampSource = source;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the clock used for sensor event timestamps.
+
+    @return The timestamp source.
+*/
+/**************************************************************************/
+fxos8700TimestampSource_t Adafruit_FXOS8700::getTimestampSource() {
+  return _timestampSource;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Uses a custom clock, e.g. a hardware timer, for sensor event
+            timestamps.
+
+    @param  clock Function returning the current time, or NULL to go back
+                  to millis().
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::setTimestampClock(uint32_t (*clock)(void)) {
+  _timestampClock = clock;
+  _timestampSource = clock ? TIMESTAMP_CUSTOM : TIMESTAMP_MILLIS;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets running statistics of the interval between samples read
+            from the sensor, in microseconds.
+
+            Samples served from the cache don't count, so this reflects
+            how regularly the bus reads happen against the ODR.
+
+    @param  stats The fxos8700IntervalStats_t to fill in.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::getIntervalStats(fxos8700IntervalStats_t *stats) {
+  stats->count = _intervalCount;
+  stats->min = _intervalMin;
+  stats->max = _intervalMax;
+  stats->mean = _intervalCount ? _intervalTotal / _intervalCount : 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Resets the sample interval statistics.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::resetIntervalStats() {
+  _intervalStarted = false;
+  _intervalCount = 0;
+  _intervalMin = 0;
+  _intervalMax = 0;
+  _intervalTotal = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets sensor_t data for both the accel and mag in one operation.
+
+    @param    accelSensor
+              A reference to the sensor_t instances where the
+              accelerometer sensor info should be written.
+    @param    magSensor
+              A reference to the sensor_t instances where the
+              magnetometer sensor info should be written.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::getSensor(sensor_t *accelSensor, sensor_t *magSensor) {
+  /* Clear the sensor_t object */
+  memset(accelSensor, 0, sizeof(sensor_t));
+  memset(magSensor, 0, sizeof(sensor_t));
+
+  /* Insert the sensor name in the fixed length char array */
+  strncpy(accelSensor->name, "FXOS8700", sizeof(accelSensor->name) - 1);
+  accelSensor->name[sizeof(accelSensor->name) - 1] = 0;
+  accelSensor->version = 1;
+  accelSensor->sensor_id = _accelSensorID;
+  accelSensor->type = SENSOR_TYPE_ACCELEROMETER;
+  accelSensor->min_delay = 0.01F; // 100Hz
+  /* 14-bit two's complement, -8192 to +8191 counts, so the range is one
+     LSB short of full scale on the positive side, e.g. -2g to +1.999g */
+  accelSensor->max_value = 8191 * _accelScale;
+  accelSensor->min_value = -8192 * _accelScale;
+  accelSensor->resolution = _accelScale;
+
+  strncpy(magSensor->name, "FXOS8700", sizeof(magSensor->name) - 1);
+  magSensor->name[sizeof(magSensor->name) - 1] = 0;
+  magSensor->version = 1;
+  magSensor->sensor_id = _magSensorID;
+  magSensor->type = SENSOR_TYPE_MAGNETIC_FIELD;
+  magSensor->min_delay = 0.01F; // 100Hz
+  magSensor->max_value = 1200.0F;
+  magSensor->min_value = -1200.0F;
+  magSensor->resolution = 0.1F;
+}
+
+/**************************************************************************/
+/*!
+    @brief    Reads a single sensor event, from the enabled sensor in
+              accel/mag-only mode, or as set by setHybridEvent() in hybrid
+              mode.
+
+    @attention
+
+    This function exists to keep Adafruit_Sensor happy since we
+    need a single sensor in the canonical .getEvent call. The
+    non-standard .getEvent call with two parameters should
+    generally be used with this sensor.
+
+    In hybrid mode both sensors are read in one burst, and the one not
+    reported is cached, so a following event for it (the next alternating
+    event, or the split Adafruit_Sensor objects) costs no bus transfer
+    until the next sample is due.
+
+    @param    singleSensorEvent
+              A reference to the sensors_event_t instances where the
+              accelerometer or magnetometer data should be written.
+
+    @return True if the event read was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::getEvent(sensors_event_t *singleSensorEvent) {
+  switch (_mode) {
+  case ACCEL_ONLY_MODE:
+    return getEvent(singleSensorEvent, NULL);
+  case MAG_ONLY_MODE:
+    return getEvent(NULL, singleSensorEvent);
+  default:
+    break;
+  }
+
+  bool mag = _hybridEvent == HYBRID_EVENT_MAG;
+  if (_hybridEvent == HYBRID_EVENT_ALTERNATE) {
+    /* A pair starts with a fresh burst, so the mag event that ends it
+       is always from the same sample as the accel event */
+    mag = _hybridMagNext;
+    if (!mag)
+      _sampleCached = false;
+  }
+
+  if (!getCachedEvent(mag ? NULL : singleSensorEvent,
+                      mag ? singleSensorEvent : NULL))
+    return false;
+
+  if (_hybridEvent == HYBRID_EVENT_ALTERNATE)
+    _hybridMagNext = !mag;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief   Gets sensor details about the sensor getEvent(sensors_event_t
+             *) reports, the accelerometer when alternating.
+
+    @attention
+
+    This function exists to keep Adafruit_Sensor happy since we
+    need a single sensor in the canonical .getSensor call. The
+    non-standard .getSensor call with two parameters should
+    generally be used with this sensor.
+
+    @param   accelSensor
+             A reference to the sensor_t instances where the
+             sensor info should be written.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::getSensor(sensor_t *accelSensor) {
+  sensor_t other;
+
+  if (_mode == MAG_ONLY_MODE ||
+      (_mode == HYBRID_MODE && _hybridEvent == HYBRID_EVENT_MAG))
+    return getSensor(&other, accelSensor);
+  return getSensor(accelSensor, &other);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Puts device into/out of standby mode
+
+            Blocks until SYSMOD reports the new mode, polling every
+            FXOS8700_STANDBY_POLL_US, for at most
+            FXOS8700_STANDBY_TIMEOUT_US.
+
+    @param standby Set this to a non-zero value to enter standy mode.
+
+    @return True if the mode changed, false on timeout or bus error.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::standby(boolean standby) {
+  fxos8700Status_t status = requestStandby(standby);
+
+  while (status == FXOS8700_PENDING) {
+    status = pollStandby();
+    if (status == FXOS8700_PENDING)
+      delayMicroseconds(FXOS8700_STANDBY_POLL_US);
+  }
+
+  if (status != FXOS8700_OK)
+    _lastError = status;
+  return status == FXOS8700_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts a transition into/out of standby mode without waiting
+            for it to complete. Call pollStandby() until it stops returning
+            FXOS8700_PENDING.
+
+    @param standby Set this to a non-zero value to enter standy mode.
+    @param timeout_us Deadline for the transition, in microseconds.
+
+    @return FXOS8700_PENDING if the transition was started, or
+            FXOS8700_BUS_ERROR if the CTRL_REG1 write failed.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::requestStandby(boolean standby,
+                                                   uint32_t timeout_us) {
+  if (!writeBits(FXOS8700_REGISTER_CTRL_REG1, 1, 0, standby ? 0 : 1)) {
+    _standbyPending = false;
+    return FXOS8700_BUS_ERROR;
+  }
+
+#if FXOS8700_ENABLE_STATS
+  if (standby)
+    _stats.standbyCycles++;
+#endif
+
+  _standbyPending = true;
+  _standbyTarget = standby;
+  _standbyStart = micros();
+  _standbyTimeout = timeout_us;
+
+  return FXOS8700_PENDING;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks on a transition started by requestStandby(), with a
+            single SYSMOD read.
+
+    @return FXOS8700_OK once SYSMOD reports the requested mode (or if no
+            transition is in progress), FXOS8700_PENDING while waiting,
+            FXOS8700_TIMEOUT once the deadline has passed, or
+            FXOS8700_BUS_ERROR if the SYSMOD read failed.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::pollStandby() {
+  if (!_standbyPending)
+    return FXOS8700_OK;
+
+  uint8_t sysmod;
+  if (!readRegisters(FXOS8600_REGISTER_SYSMOD, &sysmod, 1)) {
+    _standbyPending = false;
+    return FXOS8700_BUS_ERROR;
+  }
+
+  /* sysmod[1:0] */
+  if (((sysmod & 0x03) == STANDBY) == _standbyTarget) {
+    _standbyPending = false;
+    return FXOS8700_OK;
+  }
+
+  if ((uint32_t)(micros() - _standbyStart) >= _standbyTimeout) {
+    _standbyPending = false;
+    return FXOS8700_TIMEOUT;
+  }
+
+  return FXOS8700_PENDING;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Applies a complete sensor configuration in one standby/active
+            cycle.
+
+            Unlike calling each setter in turn, which enters and leaves
+            standby every time, the register values are computed up front
+            and written in bursts while the sensor is in standby once.
+
+    @param  config The configuration to apply.
+
+    @return True if the configuration was applied, false if the output
+            data rate isn't available in the requested sensor mode or a
+            bus transfer failed, see getLastError(). After a bus error the
+            previous configuration is kept by getConfig() and the shadow
+            registers.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::applyConfig(const fxos8700Config_t &config) {
+  uint8_t odr;
+  if (!lookupOutputDataRate(config.mode, config.rate, &odr))
+    return false;
+
+  if (!standby(true))
+    return false;
+
+  /* dr[2:0] and lnoise, with the active bit still clear, standby(false)
+     sets it. lnoise has to stay low in 8g range, or the sensor can't
+     measure past 4g */
+  uint8_t ctrl[5] = {_ctrlReg[0], _ctrlReg[1], _ctrlReg[2], _ctrlReg[3],
+                     _ctrlReg[4]};
+  ctrl[0] = (ctrl[0] & ~0x3C) | odr;
+  if (config.lowNoise && config.range != ACCEL_RANGE_8G)
+    ctrl[0] |= 0x04;
+
+  /* fs[1:0] */
+  uint8_t xyzDataCfg = (_xyzDataCfg & ~0x03) | config.range;
+
+  /* m_os[2:0] and m_hms[1:0], with hyb_autoinc_mode set in hybrid mode */
+  uint8_t mctrl[3] = {_mctrlReg[0], _mctrlReg[1], _mctrlReg[2]};
+  mctrl[0] = (mctrl[0] & ~0x1F) | (config.ratio << 2) | config.mode;
+  mctrl[1] &= ~0x20;
+  if (config.mode == HYBRID_MODE)
+    mctrl[1] |= 0x20;
+
+  bool written =
+      writeRegister(FXOS8700_REGISTER_XYZ_DATA_CFG, xyzDataCfg) &&
+      writeRegisters(FXOS8700_REGISTER_CTRL_REG1, ctrl, sizeof(ctrl)) &&
+      writeRegisters(FXOS8700_REGISTER_MCTRL_REG1, mctrl, sizeof(mctrl));
+
+  _sampleCached = false;
+  _hybridMagNext = false;
+  if (written) {
+    _mode = config.mode;
+    _range = config.range;
+    _rate = config.rate;
+    _ratio = config.ratio;
+    updateAccelScale();
+  }
+
+  return standby(false) && written;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the current sensor configuration.
+
+    @param  config The fxos8700Config_t to fill in.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::getConfig(fxos8700Config_t *config) {
+  config->mode = _mode;
+  config->range = _range;
+  config->rate = _rate;
+  config->ratio = _ratio;
+  config->lowNoise = _ctrlReg[0] & 0x04;
+}
+
+/*!
+    @brief  Gets an Adafruit Unified Sensor object for the accelerometer
+    sensor component
+    @return Adafruit_Sensor pointer to accelerometer sensor
+ */
+Adafruit_Sensor *Adafruit_FXOS8700::getAccelerometerSensor(void) {
+  return accel_sensor;
+}
+
+/*!
+    @brief  Gets an Adafruit Unified Sensor object for the mag sensor component
+    @return Adafruit_Sensor pointer to mag sensor
+ */
+Adafruit_Sensor *Adafruit_FXOS8700::getMagnetometerSensor(void) {
+  return mag_sensor;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set the sensor mode to hybrid, or accel/mag-only modes
+
+            Hybrid mode halves the rate each dr[2:0] setting gives, so the
+            dr[2:0] bits are rewritten to keep the rate from
+            setOutputDataRate().
+
+    @param mode The sensor mode to set.
+
+    @return FXOS8700_OK if the setting was written, FXOS8700_UNSUPPORTED if
+            the current output data rate isn't available in the new mode,
+            or FXOS8700_BUS_ERROR if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::setSensorMode(fxos8700SensorMode_t mode) {
+  uint8_t odr;
+
+  if (!lookupOutputDataRate(mode, _rate, &odr))
+    return FXOS8700_UNSUPPORTED;
+
+  if (!standby(true))
+    return FXOS8700_BUS_ERROR;
+  bool written = writeBits(FXOS8700_REGISTER_MCTRL_REG1, 2, 0, mode) &&
+                 writeBits(FXOS8700_REGISTER_MCTRL_REG2, 1, 5,
+                           mode == HYBRID_MODE ? 1 : 0) &&
+                 writeBits(FXOS8700_REGISTER_CTRL_REG1, 3, 3, odr >> 3);
+
+  _sampleCached = false;
+  _hybridMagNext = false;
+  if (written)
+    _mode = mode;
+
+  if (!standby(false) || !written)
+    return FXOS8700_BUS_ERROR;
+  return FXOS8700_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the sensor mode (either hybrid, or accel/mag-only).
+
+    @return The sensor mode.
+*/
+/**************************************************************************/
+fxos8700SensorMode_t Adafruit_FXOS8700::getSensorMode() { return _mode; }
+
+/**************************************************************************/
+/*!
+    @brief  Sets which sensor getEvent(sensors_event_t *) reports in hybrid
+            mode.
+
+    @param  event The sensor to report, or HYBRID_EVENT_ALTERNATE.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::setHybridEvent(fxos8700HybridEvent_t event) {
+  _hybridEvent = event;
+  _hybridMagNext = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets which sensor getEvent(sensors_event_t *) reports in hybrid
+            mode.
+
+    @return The fxos8700HybridEvent_t set with setHybridEvent().
+*/
+/**************************************************************************/
+fxos8700HybridEvent_t Adafruit_FXOS8700::getHybridEvent() {
+  return _hybridEvent;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set the accelerometer full scale range.
+
+    @attention
+
+    This function resets the lnoise bit to low if a 8G accelerometer range
+    is requested. Otherwise, the active lnoise bit won't allow the sensor
+    to measure past 4G.
+
+    @param range The accelerometer full scale range to set.
+
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::setAccelRange(fxos8700AccelRange_t range) {
+  if (!standby(true))
+    return FXOS8700_BUS_ERROR;
+  bool written = (range != ACCEL_RANGE_8G ||
+                  writeBits(FXOS8700_REGISTER_CTRL_REG1, 1, 2, 0x00)) &&
+                 writeBits(FXOS8700_REGISTER_XYZ_DATA_CFG, 2, 0, range);
+
+  /* The conversion only follows a range the sensor is actually in */
+  if (written) {
+    _range = range;
+    updateAccelScale();
+  }
+
+  if (!standby(false) || !written)
+    return FXOS8700_BUS_ERROR;
+  return FXOS8700_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the accelerometer full scale range.
+
+    @return The accelerometer full scale range.
+*/
+/**************************************************************************/
+fxos8700AccelRange_t Adafruit_FXOS8700::getAccelRange() { return _range; }
+
+/**************************************************************************/
+/*!
+    @brief  Set the fixed-point format used by readAccelFixed() and
+            convertAccelFixed().
+
+    @param format The fixed-point format to set.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700::setAccelFixedFormat(fxos8700FixedFormat_t format) {
+  _fixedFormat = format;
+  updateAccelScale();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the fixed-point format used by readAccelFixed().
+
+    @return The fixed-point format.
+*/
+/**************************************************************************/
+fxos8700FixedFormat_t Adafruit_FXOS8700::getAccelFixedFormat() {
+  return _fixedFormat;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set the FXOS8700's ODR from any sensor mode.
+
+            Only the dr[2:0] bits of CTRL_REG1 are changed, so lnoise and
+            the auto-sleep rate are kept. Setting the current rate again
+            doesn't touch the bus.
+
+    @param rate The FXOS8700's ODR.
+
+    @return FXOS8700_OK if the rate was set, FXOS8700_UNSUPPORTED if it
+            isn't available in the current sensor mode, or
+            FXOS8700_BUS_ERROR if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::setOutputDataRate(fxos8700ODR_t rate) {
+  uint8_t odr;
+
+  if (!lookupOutputDataRate(_mode, rate, &odr))
+    return FXOS8700_UNSUPPORTED;
+
+  if ((_ctrlReg[0] & 0x38) == odr) {
+    _rate = rate;
+    return FXOS8700_OK;
+  }
+
+  if (!standby(true))
+    return FXOS8700_BUS_ERROR;
+  bool written = writeBits(FXOS8700_REGISTER_CTRL_REG1, 3, 3, odr >> 3);
+  if (written)
+    _rate = rate;
+
+  if (!standby(false) || !written)
+    return FXOS8700_BUS_ERROR;
+  return FXOS8700_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the FXOS8700's Hybrid ODR.
+
+    @return The FXOS8700's Hybrid ODR.
+*/
+/**************************************************************************/
+fxos8700ODR_t Adafruit_FXOS8700::getOutputDataRate() { return _rate; }
+
+/**************************************************************************/
+/*!
+    @brief  Get the rate each enabled sensor is sampled at.
+
+            This is worked out from the dr[2:0] bits written to the sensor
+            and the current mode, so it is the rate actually in effect.
+
+    @return The output data rate in Hz.
+*/
+/**************************************************************************/
+float Adafruit_FXOS8700::getOutputDataRateHz() {
+  float hz = FXOS8700_DR_HZ[(_ctrlReg[0] >> 3) & 0x07];
+  return (_mode == HYBRID_MODE) ? hz / 2 : hz;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set the magnetometer oversampling ratio (OSR)
+
+    @param ratio The magnetometer OSR to set.
+
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t
+Adafruit_FXOS8700::setMagOversamplingRatio(fxos8700MagOSR_t ratio) {
+  if (!standby(true))
+    return FXOS8700_BUS_ERROR;
+  bool written = writeBits(FXOS8700_REGISTER_MCTRL_REG1, 3, 2, ratio);
+  if (written)
+    _ratio = ratio;
+
+  if (!standby(false) || !written)
+    return FXOS8700_BUS_ERROR;
+  return FXOS8700_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the magnetometer oversampling ratio (OSR).
+
+    @return The magnetometer OSR.
+*/
+/**************************************************************************/
+fxos8700MagOSR_t Adafruit_FXOS8700::getMagOversamplingRatio() { return _ratio; }
+
+/**************************************************************************/
+/*!
+    @brief  Enable or disable the accelerometer high-pass filter.
+
+            With the filter enabled the chip removes gravity and any other
+            slowly changing bias from the output registers and the FIFO
+            (hpf_out), so the samples need no filtering on the host.
+
+    @param enable Set to true to output high-pass filtered data.
+    @param cutoff The filter cutoff frequency.
+
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t
+Adafruit_FXOS8700::setHighPassFilter(bool enable,
+                                     fxos8700HighPassCutoff_t cutoff) {
+  /* Keep the pulse function's filter bits, only sel[1:0] changes */
+  uint8_t hpf;
+  bool ok =
+      standby(true) &&
+      readRegisters(FXOS8700_REGISTER_HP_FILTER_CUTOFF, &hpf, 1) &&
+      writeRegister(FXOS8700_REGISTER_HP_FILTER_CUTOFF,
+                    (hpf & ~0x03) | cutoff) &&
+      writeBits(FXOS8700_REGISTER_XYZ_DATA_CFG, 1, 4, enable ? 1 : 0);
+  ok = standby(false) && ok;
+
+  _sampleCached = false;
+  return ok ? FXOS8700_OK : FXOS8700_BUS_ERROR;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get whether the accelerometer high-pass filter is enabled.
+
+    @return True if the output data is high-pass filtered.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::getHighPassFilter() { return _xyzDataCfg & 0x10; }
+
+/**************************************************************************/
+/*!
+    @brief  Writes the accelerometer offset registers.
+
+            The chip adds these offsets to every accelerometer sample,
+            including those in the FIFO, so no per-sample bias correction
+            is needed on the host. Values from calibrateAccelOffsets() can
+            be stored (e.g. in EEPROM) and restored here at boot.
+
+    @param  offsets The offsets for each axis, in FXOS8700_ACCEL_OFFSET_MG
+                    steps. Values outside -128..127 are clamped.
+
+    @return True if the write was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::setAccelOffsets(const fxos8700RawData_t *offsets) {
+  uint8_t buffer[3];
+  int16_t const axes[3] = {offsets->x, offsets->y, offsets->z};
+
+  for (uint8_t i = 0; i < 3; i++) {
+    int16_t value = axes[i];
+    if (value < -128)
+      value = -128;
+    if (value > 127)
+      value = 127;
+    buffer[i] = (uint8_t)(int8_t)value;
+  }
+
+  bool ok = standby(true) &&
+            writeRegisters(FXOS8700_REGISTER_OFF_X, buffer, sizeof(buffer));
+  ok = standby(false) && ok;
+
+  _sampleCached = false;
+  return ok;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the accelerometer offset registers.
+
+    @param  offsets The fxos8700RawData_t to fill in, in
+                    FXOS8700_ACCEL_OFFSET_MG steps.
+
+    @return True if the read was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::getAccelOffsets(fxos8700RawData_t *offsets) {
+  uint8_t buffer[3];
+  if (!readRegisters(FXOS8700_REGISTER_OFF_X, buffer, sizeof(buffer)))
+    return false;
+
+  offsets->x = (int8_t)buffer[0];
+  offsets->y = (int8_t)buffer[1];
+  offsets->z = (int8_t)buffer[2];
+
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Measures the accelerometer zero-g offsets and writes the
+            correction into the offset registers.
+
+            The sensor has to lie still with one axis pointing straight up,
+            so that axis reads +1g and the other two 0g. Any existing
+            offsets are cleared and the high-pass filter is bypassed while
+            measuring, then both are set again before returning. This
+            blocks for about samples / getOutputDataRateHz() seconds.
+
+    @param  up The axis pointing up, AXIS_X, AXIS_Y or AXIS_Z.
+    @param  samples The number of samples to average.
+    @param  offsets The fxos8700RawData_t to fill in with the offsets that
+                    were written, or NULL.
+
+    @return True if the offsets were measured and written, false if the
+            accelerometer or the FIFO is in use, or the sensor stopped
+            delivering samples.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::calibrateAccelOffsets(fxos8700Axis_t up,
+                                              uint16_t samples,
+                                              fxos8700RawData_t *offsets) {
+  /* STATUS is only DR_STATUS with the FIFO off */
+  if (_mode == MAG_ONLY_MODE || _fifoMode != FIFO_MODE_DISABLED ||
+      samples == 0)
+    return false;
+  if (up != AXIS_X && up != AXIS_Y && up != AXIS_Z)
+    return false;
+
+  /* Measure the uncorrected, unfiltered output */
+  uint8_t xyzDataCfg = _xyzDataCfg;
+  const uint8_t zero[3] = {0, 0, 0};
+  bool ok = standby(true) &&
+            writeRegisters(FXOS8700_REGISTER_OFF_X, zero, sizeof(zero)) &&
+            writeRegister(FXOS8700_REGISTER_XYZ_DATA_CFG, xyzDataCfg & ~0x10);
+  ok = standby(false) && ok;
+  _sampleCached = false;
+
+  /* Allow twice the sample period per sample before giving up */
+  uint32_t timeout = (2.0F * (samples + 1) * 1000000.0F) /
+                     getOutputDataRateHz();
+  uint32_t start = micros();
+  int32_t sum[3] = {0, 0, 0};
+  uint16_t count = 0;
+  bool first = true;
+
+  while (ok && count < samples) {
+    if ((uint32_t)(micros() - start) >= timeout) {
+      ok = false;
+      break;
+    }
+
+    fxos8700Sample_t sample;
+    if (!readSample(&sample)) {
+      ok = false;
+      break;
+    }
+    /* zyxdr, and skip the first sample, which may predate the changes */
+    if (!(sample.status & 0x08))
+      continue;
+    if (first) {
+      first = false;
+      continue;
+    }
+
+    sum[0] += sample.accel.x;
+    sum[1] += sample.accel.y;
+    sum[2] += sample.accel.z;
+    count++;
+  }
+
+  fxos8700RawData_t correction = {0, 0, 0};
+  if (ok) {
+    float mg_lsb = _accelScale / SENSORS_GRAVITY_STANDARD * 1000.0F;
+    int16_t *const axes[3] = {&correction.x, &correction.y, &correction.z};
+
+    for (uint8_t i = 0; i < 3; i++) {
+      float expected = (up == (1 << i)) ? 1000.0F : 0.0F;
+      float error = (float)sum[i] / count * mg_lsb - expected;
+      float steps = -error / FXOS8700_ACCEL_OFFSET_MG;
+      if (steps < -128.0F)
+        steps = -128.0F;
+      if (steps > 127.0F)
+        steps = 127.0F;
+      *axes[i] = (int16_t)(steps + ((steps < 0) ? -0.5F : 0.5F));
+    }
+    if (offsets)
+      *offsets = correction;
+  }
+
+  /* Restore the filter setting, even if the measurement failed */
+  const uint8_t buffer[3] = {(uint8_t)(int8_t)correction.x,
+                             (uint8_t)(int8_t)correction.y,
+                             (uint8_t)(int8_t)correction.z};
+  bool written =
+      standby(true) &&
+      writeRegisters(FXOS8700_REGISTER_OFF_X, buffer, sizeof(buffer)) &&
+      writeRegister(FXOS8700_REGISTER_XYZ_DATA_CFG, xyzDataCfg);
+  written = standby(false) && written;
+  _sampleCached = false;
+
+  return ok && written;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes the magnetometer hard-iron offset registers.
+
+            The chip subtracts these offsets from every magnetometer sample,
+            so no per-sample correction is needed on the host. Values read
+            back with getMagOffsets() after a calibration run can be stored
+            (e.g. in EEPROM) and restored here at boot.
+
+    @attention
+
+    If auto-calibration is enabled the chip keeps overwriting these
+    registers, so restore saved offsets with it disabled.
+
+    @param  offsets The offsets for each axis, in raw magnetometer counts
+                    (0.1uT per LSB, 15-bit signed range).
+
+    @return True if the write was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::setMagOffsets(const fxos8700RawData_t *offsets) {
+  uint8_t buffer[6];
+  int16_t const axes[3] = {offsets->x, offsets->y, offsets->z};
+
+  /* The offsets are 15-bit and left-aligned, bit 0 of each LSB is unused */
+  for (uint8_t i = 0; i < 3; i++) {
+    uint16_t value = (uint16_t)axes[i] << 1;
+    buffer[i * 2] = value >> 8;
+    buffer[i * 2 + 1] = value & 0xFF;
+  }
+
+  return writeRegisters(FXOS8700_REGISTER_MOFF_X_MSB, buffer, 6);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the magnetometer hard-iron offset registers.
+
+    @param  offsets The fxos8700RawData_t to fill in, in raw magnetometer
+                    counts (0.1uT per LSB).
+
+    @return True if the read was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::getMagOffsets(fxos8700RawData_t *offsets) {
+  uint8_t buffer[6];
+  if (!readRegisters(FXOS8700_REGISTER_MOFF_X_MSB, buffer, 6))
+    return false;
+
+  offsets->x = (int16_t)((buffer[0] << 8) | buffer[1]) >> 1;
+  offsets->y = (int16_t)((buffer[2] << 8) | buffer[3]) >> 1;
+  offsets->z = (int16_t)((buffer[4] << 8) | buffer[5]) >> 1;
+
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Enable or disable the magnetometer hard-iron auto-calibration.
+
+            While enabled the chip writes the midpoint of the tracked
+            min/max values into the offset registers, see getMagMinMax().
+
+    @param enable Set to true to enable auto-calibration (m_acal).
+
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::enableMagAutoCalibration(bool enable) {
+  bool ok = standby(true) &&
+            writeBits(FXOS8700_REGISTER_MCTRL_REG1, 1, 7, enable ? 1 : 0);
+  ok = standby(false) && ok;
+
+  return ok ? FXOS8700_OK : FXOS8700_BUS_ERROR;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get whether the magnetometer auto-calibration is enabled.
+
+    @return True if auto-calibration is enabled.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::getMagAutoCalibration() {
+  return _mctrlReg[0] & 0x80;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Enable or disable the magnetometer min/max tracking.
+
+    @param enable Set to true to track the min/max values (clears
+                  m_maxmin_dis).
+
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the transfer failed.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::enableMagMinMax(bool enable) {
+  if (!writeBits(FXOS8700_REGISTER_MCTRL_REG2, 1, 4, enable ? 0 : 1))
+    return FXOS8700_BUS_ERROR;
+  return FXOS8700_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Resets the tracked magnetometer min/max values, which restarts
+            auto-calibration from scratch.
+
+    @return FXOS8700_OK if the reset was written, or FXOS8700_BUS_ERROR if
+            the transfer failed and the old min/max values are still in
+            place.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::resetMagMinMax() {
+  if (!writeBits(FXOS8700_REGISTER_MCTRL_REG2, 1, 2, 1))
+    return FXOS8700_BUS_ERROR;
+
+  /* m_maxmin_rst clears itself, keep it out of the shadow copy so later
+     writes don't reset the values again */
+  _mctrlReg[1] &= ~0x04;
+  return FXOS8700_OK;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the tracked magnetometer min/max values.
+
+    @param  minValues The fxos8700RawData_t to fill in with the minimum
+                      values.
+    @param  maxValues The fxos8700RawData_t to fill in with the maximum
+                      values.
+
+    @return True if the read was successful, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::getMagMinMax(fxos8700RawData_t *minValues,
+                                     fxos8700RawData_t *maxValues) {
+  uint8_t buffer[12];
+  if (!readRegisters(FXOS8700_REGISTER_MMAX_X_MSB, buffer, 12))
+    return false;
+
+  fxos8700DecodeMag(&buffer[0], maxValues);
+  fxos8700DecodeMag(&buffer[6], minValues);
+
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set the accelerometer FIFO mode and watermark.
+
+    @attention
+
+    While the FIFO is enabled, reading from FXOS8700_REGISTER_OUT_X_MSB
+    pops samples from the FIFO, so getEvent() and readFifo() will consume
+    the same buffer.
+
+    @param mode The FIFO mode to set.
+    @param watermark Sample count (1..32) that sets the f_wmrk_flag, or 0
+                     to disable the watermark.
+
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::setFifoMode(fxos8700FifoMode_t mode,
+                                                uint8_t watermark) {
+  if (watermark > FXOS8700_FIFO_SIZE)
+    watermark = FXOS8700_FIFO_SIZE;
+
+  if (!standby(true))
+    return FXOS8700_BUS_ERROR;
+
+  /* Switching between two enabled FIFO modes must go through disabled */
+  bool written = true;
+  if (_fifoMode != FIFO_MODE_DISABLED && mode != FIFO_MODE_DISABLED) {
+    written = writeRegister(FXOS8700_REGISTER_F_SETUP, 0x00);
+    if (written)
+      _fifoMode = FIFO_MODE_DISABLED;
+  }
+  written = written &&
+            writeRegister(FXOS8700_REGISTER_F_SETUP, (mode << 6) | watermark);
+  if (written)
+    _fifoMode = mode;
+
+  if (!standby(false) || !written)
+    return FXOS8700_BUS_ERROR;
+  return FXOS8700_OK;
+}
 
 /**************************************************************************/
 /*!
-    @brief  Initializes the hardware.
+    @brief  Get the accelerometer FIFO mode.
 
-    @param  addr I2C address for the device.
-    @param  wire Pointer to Wire instance
-
-    @return True if the device was successfully initialized, otherwise false.
+    @return The accelerometer FIFO mode.
 */
 /**************************************************************************/
-bool Adafruit_FXOS8700::begin(uint8_t addr, TwoWire *wire) {
-  if (i2c_dev)
-    delete i2c_dev;
-  i2c_dev = new Adafruit_I2CDevice(addr, wire);
-  if (!i2c_dev->begin())
-    return false;
+fxos8700FifoMode_t Adafruit_FXOS8700::getFifoMode() { return _fifoMode; }
 
-  Adafruit_BusIO_Register WHO_AM_I(i2c_dev, FXOS8700_REGISTER_WHO_AM_I);
-  if (WHO_AM_I.read() != FXOS8700_ID)
-    return false;
+/**************************************************************************/
+/*!
+    @brief  Get the number of samples waiting in the accelerometer FIFO.
 
-  return initialize();
+    @return The f_cnt[5:0] sample count from F_STATUS, or 0 if the FIFO is
+            disabled or F_STATUS couldn't be read, in which case
+            getLastError() returns FXOS8700_BUS_ERROR.
+*/
+/**************************************************************************/
+uint8_t Adafruit_FXOS8700::getFifoCount() {
+  if (_fifoMode == FIFO_MODE_DISABLED)
+    return 0;
+
+  /* f_cnt[5:0] in F_STATUS */
+  uint8_t status;
+  if (!readRegister(FXOS8700_REGISTER_STATUS, &status))
+    return 0;
+  return status & 0x3F;
 }
 
 /**************************************************************************/
 /*!
-    @brief  Gets the most recent sensor events.
+    @brief  Drains the accelerometer FIFO in a single burst transaction.
 
-            This function reads from both the accelerometer and the
-            magnetometer in one call, and is a deviation from the standard
-            Adafruit_Sensor API, but is provided as a convenience since most
-            AHRS algorithms require sensor samples to be as close in time as
-            possible.
+            The samples are read straight into the caller's buffer and
+            decoded in place, oldest sample first.
 
-    @param    accelEvent
-              A reference to the sensors_event_t instances where the
-              accelerometer data should be written.
-    @param    magEvent
-              A reference to the sensors_event_t instances where the
-              magnetometer data should be written.
+    @param  out
+            Buffer that receives the raw accelerometer samples.
+    @param  maxSamples
+            Capacity of the buffer, in samples.
 
-    @return True if the event read was successful, otherwise false.
+    @return The number of samples read, 0 if the FIFO is empty, disabled or
+            a transfer failed. getLastError() tells the last case apart.
 */
 /**************************************************************************/
-bool Adafruit_FXOS8700::getEvent(sensors_event_t *accelEvent,
-                                 sensors_event_t *magEvent) {
-
-  /* Read 13 bytes from the sensor */
-  uint8_t buffer[13];
-  buffer[0] = FXOS8700_REGISTER_STATUS;
-  i2c_dev->write_then_read(buffer, 1, buffer, 13);
-
-  uint32_t const timestamp = millis();
-
-  if (accelEvent) {
-    /* Clear the event */
-    memset(accelEvent, 0, sizeof(sensors_event_t));
+size_t Adafruit_FXOS8700::readFifo(fxos8700RawData_t *out, size_t maxSamples) {
+  runPendingRecovery();
+  size_t count = getFifoCount();
+  if (count > maxSamples)
+    count = maxSamples;
+  if (count == 0)
+    return 0;
+
+  /* Read every sample in one go, while the FIFO is enabled the address
+     pointer wraps from OUT_Z_LSB back to OUT_X_MSB after each sample */
+  uint8_t *buffer = (uint8_t *)out;
+  if (!readRegisters(FXOS8700_REGISTER_OUT_X_MSB, buffer, count * 6))
+    return 0;
+
+  /* Each 6 byte sample occupies exactly one fxos8700RawData_t, so decode
+     in place */
+  for (size_t i = 0; i < count; i++)
+    fxos8700DecodeAccel(buffer + (i * 6), &out[i]);
+
+  return count;
+}
 
-    /* Clear the raw data placeholder */
-    accel_raw.x = 0;
-    accel_raw.y = 0;
-    accel_raw.z = 0;
+/**************************************************************************/
+/*!
+    @brief  Enable or disable the data-ready interrupt.
 
-    /* Set the static metadata */
-    accelEvent->version = sizeof(sensors_event_t);
-    accelEvent->sensor_id = _accelSensorID;
-    accelEvent->type = SENSOR_TYPE_ACCELEROMETER;
+    @param enable Set to true to assert the interrupt pin on new data.
+    @param intPin The interrupt pin (INT1 or INT2) the data-ready
+                  interrupt is routed to.
 
-    /* Set the timestamps */
-    accelEvent->timestamp = timestamp;
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::enableDataReadyInterrupt(
+    bool enable, fxos8700InterruptPin_t intPin) {
+  bool ok = standby(true) && routeInterrupt(INT_SOURCE_DRDY, enable, intPin);
+  ok = standby(false) && ok;
 
-    /* Shift values to create properly formed integers */
-    /* Note, accel data is 14-bit and left-aligned, so we shift two bit right */
-    accelEvent->acceleration.x = (int16_t)((buffer[1] << 8) | buffer[2]) >> 2;
-    accelEvent->acceleration.y = (int16_t)((buffer[3] << 8) | buffer[4]) >> 2;
-    accelEvent->acceleration.z = (int16_t)((buffer[5] << 8) | buffer[6]) >> 2;
+  return ok ? FXOS8700_OK : FXOS8700_BUS_ERROR;
+}
 
-    /* Assign raw values in case someone needs them */
-    accel_raw.x = accelEvent->acceleration.x;
-    accel_raw.y = accelEvent->acceleration.y;
-    accel_raw.z = accelEvent->acceleration.z;
+/**************************************************************************/
+/*!
+    @brief  Enable the data-ready interrupt and attach a callback to the
+            host pin it is wired to.
 
-    /* Convert accel values to m/s^2 */
-    switch (_range) {
-    case (ACCEL_RANGE_2G):
-      accelEvent->acceleration.x *= ACCEL_MG_LSB_2G * SENSORS_GRAVITY_STANDARD;
-      accelEvent->acceleration.y *= ACCEL_MG_LSB_2G * SENSORS_GRAVITY_STANDARD;
-      accelEvent->acceleration.z *= ACCEL_MG_LSB_2G * SENSORS_GRAVITY_STANDARD;
-      break;
-    case (ACCEL_RANGE_4G):
-      accelEvent->acceleration.x *= ACCEL_MG_LSB_4G * SENSORS_GRAVITY_STANDARD;
-      accelEvent->acceleration.y *= ACCEL_MG_LSB_4G * SENSORS_GRAVITY_STANDARD;
-      accelEvent->acceleration.z *= ACCEL_MG_LSB_4G * SENSORS_GRAVITY_STANDARD;
-      break;
-    case (ACCEL_RANGE_8G):
-      accelEvent->acceleration.x *= ACCEL_MG_LSB_8G * SENSORS_GRAVITY_STANDARD;
-      accelEvent->acceleration.y *= ACCEL_MG_LSB_8G * SENSORS_GRAVITY_STANDARD;
-      accelEvent->acceleration.z *= ACCEL_MG_LSB_8G * SENSORS_GRAVITY_STANDARD;
-      break;
-    }
-  }
+    @attention
 
-  if (magEvent) {
-    memset(magEvent, 0, sizeof(sensors_event_t));
+    The callback runs in interrupt context, so it should only set a flag
+    and leave the bus transfer to the main loop.
 
-    mag_raw.x = 0;
-    mag_raw.y = 0;
-    mag_raw.z = 0;
+    @param pin The host pin connected to the selected FXOS8700 INT pin.
+    @param callback The function to call when new data is ready.
+    @param intPin The interrupt pin (INT1 or INT2) the data-ready
+                  interrupt is routed to.
 
-    magEvent->version = sizeof(sensors_event_t);
-    magEvent->sensor_id = _magSensorID;
-    magEvent->type = SENSOR_TYPE_MAGNETIC_FIELD;
+    @return True if the interrupt was attached and enabled, otherwise
+            false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::attachDataReadyInterrupt(
+    uint8_t pin, void (*callback)(void), fxos8700InterruptPin_t intPin) {
+  if (!attachEventInterrupt(pin, callback))
+    return false;
 
-    magEvent->timestamp = timestamp;
+  return enableDataReadyInterrupt(true, intPin) == FXOS8700_OK;
+}
 
-    magEvent->magnetic.x = (int16_t)((buffer[7] << 8) | buffer[8]);
-    magEvent->magnetic.y = (int16_t)((buffer[9] << 8) | buffer[10]);
-    magEvent->magnetic.z = (int16_t)((buffer[11] << 8) | buffer[12]);
+/**************************************************************************/
+/*!
+    @brief  Checks whether a new sample is ready without reading it.
 
-    mag_raw.x = magEvent->magnetic.x;
-    mag_raw.y = magEvent->magnetic.y;
-    mag_raw.z = magEvent->magnetic.z;
+            The accel zyxdr bit in STATUS and/or the mag zyxdr bit in
+            M_DR_STATUS are checked depending on the sensor mode. When the
+            FIFO is enabled, the FIFO sample count is checked instead.
 
-    /* Convert mag values to uTesla */
-    magEvent->magnetic.x *= MAG_UT_LSB;
-    magEvent->magnetic.y *= MAG_UT_LSB;
-    magEvent->magnetic.z *= MAG_UT_LSB;
+    @return True if new data is ready for every sensor enabled in the
+            current mode, otherwise false. A failed status read also
+            returns false, and is reported by getLastError().
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700::available() {
+  uint8_t status;
+
+  /* zyxdr is bit 3 of both STATUS and M_DR_STATUS */
+  if (_mode != MAG_ONLY_MODE) {
+    if (_fifoMode != FIFO_MODE_DISABLED) {
+      if (getFifoCount() == 0)
+        return false;
+    } else if (!readRegister(FXOS8700_REGISTER_STATUS, &status) ||
+               !(status & 0x08)) {
+      return false;
+    }
   }
 
+  if (_mode != ACCEL_ONLY_MODE &&
+      (!readRegister(FXOS8700_REGISTER_MSTATUS, &status) || !(status & 0x08)))
+    return false;
+
   return true;
 }
 
 /**************************************************************************/
 /*!
-    @brief  Gets sensor_t data for both the accel and mag in one operation.
+    @brief  Configures single and double tap detection.
 
-    @param    accelSensor
-              A reference to the sensor_t instances where the
-              accelerometer sensor info should be written.
-    @param    magSensor
-              A reference to the sensor_t instances where the
-              magnetometer sensor info should be written.
-*/
-/**************************************************************************/
-void Adafruit_FXOS8700::getSensor(sensor_t *accelSensor, sensor_t *magSensor) {
-  /* Clear the sensor_t object */
-  memset(accelSensor, 0, sizeof(sensor_t));
-  memset(magSensor, 0, sizeof(sensor_t));
+            Taps are latched until readEvents() reads PULSE_SRC.
 
-  /* Insert the sensor name in the fixed length char array */
-  strncpy(accelSensor->name, "FXOS8700", sizeof(accelSensor->name) - 1);
-  accelSensor->name[sizeof(accelSensor->name) - 1] = 0;
-  accelSensor->version = 1;
-  accelSensor->sensor_id = _accelSensorID;
-  accelSensor->type = SENSOR_TYPE_ACCELEROMETER;
-  accelSensor->min_delay = 0.01F; // 100Hz
-  switch (_range) {
-  case (ACCEL_RANGE_2G):
-    accelSensor->max_value = 2.0F * SENSORS_GRAVITY_STANDARD;
-    accelSensor->min_value = -1.999F * SENSORS_GRAVITY_STANDARD;
-    accelSensor->resolution = ACCEL_MG_LSB_2G * SENSORS_GRAVITY_STANDARD;
-    break;
-  case (ACCEL_RANGE_4G):
-    accelSensor->max_value = 4.0F * SENSORS_GRAVITY_STANDARD;
-    accelSensor->min_value = -3.998F * SENSORS_GRAVITY_STANDARD;
-    accelSensor->resolution = ACCEL_MG_LSB_4G * SENSORS_GRAVITY_STANDARD;
-    break;
-  case (ACCEL_RANGE_8G):
-    accelSensor->max_value = 8.0F * SENSORS_GRAVITY_STANDARD;
-    accelSensor->min_value = -7.996F * SENSORS_GRAVITY_STANDARD;
-    accelSensor->resolution = ACCEL_MG_LSB_8G * SENSORS_GRAVITY_STANDARD;
-    break;
-  }
+    @param config The axes, threshold and timing to use. An axes mask of 0
+                  turns tap detection off.
+    @param intPin The interrupt pin (INT1 or INT2) the pulse interrupt is
+                  routed to.
 
-  strncpy(magSensor->name, "FXOS8700", sizeof(magSensor->name) - 1);
-  magSensor->name[sizeof(magSensor->name) - 1] = 0;
-  magSensor->version = 1;
-  magSensor->sensor_id = _magSensorID;
-  magSensor->type = SENSOR_TYPE_MAGNETIC_FIELD;
-  magSensor->min_delay = 0.01F; // 100Hz
-  magSensor->max_value = 1200.0F;
-  magSensor->min_value = -1200.0F;
-  magSensor->resolution = 0.1F;
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t
+Adafruit_FXOS8700::setTapDetection(const fxos8700TapConfig_t &config,
+                                   fxos8700InterruptPin_t intPin) {
+  /* xspefe/xdpefe, yspefe/ydpefe and zspefe/zdpefe pairs */
+  uint8_t cfg = 0;
+  uint8_t pair = config.doubleTap ? 0x03 : 0x01;
+  if (config.axes & AXIS_X)
+    cfg |= pair;
+  if (config.axes & AXIS_Y)
+    cfg |= pair << 2;
+  if (config.axes & AXIS_Z)
+    cfg |= pair << 4;
+  /* ele */
+  if (cfg)
+    cfg |= 0x40;
+
+  uint8_t ths = embeddedThreshold(config.threshold);
+  const uint8_t pulse[] = {ths, ths, ths, config.timeLimit, config.latency,
+                           config.window};
+
+  bool ok =
+      standby(true) && writeRegister(FXOS8700_REGISTER_PULSE_CFG, cfg) &&
+      writeRegisters(FXOS8700_REGISTER_PULSE_THSX, pulse, sizeof(pulse)) &&
+      routeInterrupt(INT_SOURCE_PULSE, cfg != 0, intPin);
+  ok = standby(false) && ok;
+
+  return ok ? FXOS8700_OK : FXOS8700_BUS_ERROR;
 }
 
 /**************************************************************************/
 /*!
-    @brief    Reads a single sensor event from the accelerometer.
-
-    @attention
+    @brief  Configures freefall or motion detection.
 
-    This function exists to keep Adafruit_Sensor happy since we
-    need a single sensor in the canonical .getEvent call. The
-    non-standard .getEvent call with two parameters should
-    generally be used with this sensor.
+            Events are latched until readEvents() reads A_FFMT_SRC.
 
-    @param    singleSensorEvent
-              A reference to the sensors_event_t instances where the
-              accelerometer or magnetometer data should be written.
+    @param config The axes, mode, threshold and debounce count to use. An
+                  axes mask of 0 turns detection off.
+    @param intPin The interrupt pin (INT1 or INT2) the FFMT interrupt is
+                  routed to.
 
-    @return True if the event read was successful, otherwise false.
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
 */
 /**************************************************************************/
-bool Adafruit_FXOS8700::getEvent(sensors_event_t *singleSensorEvent) {
-  sensors_event_t dummy;
-  switch (_mode) {
-  case ACCEL_ONLY_MODE:
-    return getEvent(singleSensorEvent, &dummy);
-  case MAG_ONLY_MODE:
-    return getEvent(&dummy, singleSensorEvent);
-  default:
-    return false;
-  }
+fxos8700Status_t Adafruit_FXOS8700::setFreefallMotionDetection(
+    const fxos8700FreefallMotionConfig_t &config,
+    fxos8700InterruptPin_t intPin) {
+  /* ele, oae and xefe/yefe/zefe */
+  uint8_t cfg = (config.axes & AXIS_ALL) << 3;
+  if (cfg)
+    cfg |= 0x80 | (config.motion ? 0x40 : 0x00);
+
+  /* dbcntm clears the debounce counter as soon as the condition stops */
+  const uint8_t ffmt[] = {(uint8_t)(0x80 | embeddedThreshold(config.threshold)),
+                          config.count};
+
+  bool ok =
+      standby(true) && writeRegister(FXOS8700_REGISTER_A_FFMT_CFG, cfg) &&
+      writeRegisters(FXOS8700_REGISTER_A_FFMT_THS, ffmt, sizeof(ffmt)) &&
+      routeInterrupt(INT_SOURCE_FFMT, cfg != 0, intPin);
+  ok = standby(false) && ok;
+
+  return ok ? FXOS8700_OK : FXOS8700_BUS_ERROR;
 }
 
 /**************************************************************************/
 /*!
-    @brief   Gets sensor details about the accelerometer.
+    @brief  Configures transient detection, motion measured through the
+            high-pass filter so gravity doesn't count.
+
+            Events are latched until readEvents() reads TRANSIENT_SRC.
 
     @attention
 
-    This function exists to keep Adafruit_Sensor happy since we
-    need a single sensor in the canonical .getSensor call. The
-    non-standard .getSensor call with two parameters should
-    generally be used with this sensor.
+    The transient function is shared with enableAdaptiveRate(), which
+    reconfigures it, and disableAdaptiveRate(), which turns it off.
 
-    @param   accelSensor
-             A reference to the sensor_t instances where the
-             accelerometer sensor info should be written.
+    @param config The axes, threshold and debounce count to use. An axes
+                  mask of 0 turns detection off.
+    @param intPin The interrupt pin (INT1 or INT2) the transient interrupt
+                  is routed to.
+
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
 */
 /**************************************************************************/
-void Adafruit_FXOS8700::getSensor(sensor_t *accelSensor) {
-  sensor_t accel;
-
-  return getSensor(accelSensor, &accel);
+fxos8700Status_t Adafruit_FXOS8700::setTransientDetection(
+    const fxos8700TransientConfig_t &config, fxos8700InterruptPin_t intPin) {
+  /* ele and xefe/yefe/zefe, with the high-pass filter in use */
+  uint8_t cfg = (config.axes & AXIS_ALL) << 1;
+  if (cfg)
+    cfg |= 0x10;
+
+  const uint8_t transient[] = {
+      (uint8_t)(0x80 | embeddedThreshold(config.threshold)), config.count};
+
+  bool ok = standby(true) &&
+            writeRegister(FXOS8700_REGISTER_TRANSIENT_CFG, cfg) &&
+            writeRegisters(FXOS8700_REGISTER_TRANSIENT_THS, transient,
+                           sizeof(transient)) &&
+            routeInterrupt(INT_SOURCE_TRANS, cfg != 0, intPin);
+  ok = standby(false) && ok;
+
+  return ok ? FXOS8700_OK : FXOS8700_BUS_ERROR;
 }
 
 /**************************************************************************/
 /*!
-    @brief  Puts device into/out of standby mode
+    @brief  Enables or disables portrait/landscape orientation detection,
+            with the default trip angles.
 
-    @param standby Set this to a non-zero value to enter standy mode.
+    @param enable Set to true to detect orientation changes.
+    @param count Samples a new orientation must hold for before it is
+                 reported.
+    @param intPin The interrupt pin (INT1 or INT2) the orientation
+                  interrupt is routed to.
+
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
 */
 /**************************************************************************/
-void Adafruit_FXOS8700::standby(boolean standby) {
-  Adafruit_BusIO_Register CTRL_REG1(i2c_dev, FXOS8700_REGISTER_CTRL_REG1);
-  Adafruit_BusIO_Register SYS_MOD(i2c_dev, FXOS8600_REGISTER_SYSMOD);
-  Adafruit_BusIO_RegisterBits standby_bit(&CTRL_REG1, 1, 0);
-  Adafruit_BusIO_RegisterBits sysmode(&SYS_MOD, 2, 0);
-
-  if (standby) {
-    standby_bit.write(0);
-    while (sysmode.read() != STANDBY) {
-      delay(10);
-    }
-  } else {
-    standby_bit.write(1);
-    while (sysmode.read() == STANDBY) {
-      delay(10);
-    }
-  }
+fxos8700Status_t
+Adafruit_FXOS8700::setOrientationDetection(bool enable, uint8_t count,
+                                           fxos8700InterruptPin_t intPin) {
+  /* dbcntm and pl_en */
+  const uint8_t pl[] = {(uint8_t)(0x80 | (enable ? 0x40 : 0x00)), count};
+
+  bool ok = standby(true) &&
+            writeRegisters(FXOS8700_REGISTER_PL_CFG, pl, sizeof(pl)) &&
+            routeInterrupt(INT_SOURCE_LNDPRT, enable, intPin);
+  ok = standby(false) && ok;
+
+  return ok ? FXOS8700_OK : FXOS8700_BUS_ERROR;
 }
 
+/**************************************************************************/
 /*!
-    @brief  Gets an Adafruit Unified Sensor object for the accelerometer
-    sensor component
-    @return Adafruit_Sensor pointer to accelerometer sensor
- */
-Adafruit_Sensor *Adafruit_FXOS8700::getAccelerometerSensor(void) {
-  return accel_sensor;
-}
+    @brief  Configures magnetic threshold detection.
 
-/*!
-    @brief  Gets an Adafruit Unified Sensor object for the mag sensor component
-    @return Adafruit_Sensor pointer to mag sensor
- */
-Adafruit_Sensor *Adafruit_FXOS8700::getMagnetometerSensor(void) {
-  return mag_sensor;
+            The same threshold is used for every axis. Events are latched
+            until readEvents() reads M_THS_SRC.
+
+    @param config The axes, direction, threshold and debounce count to use.
+                  An axes mask of 0 turns detection off.
+    @param intPin The interrupt pin (INT1 or INT2) the threshold interrupt
+                  is routed to.
+
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::setMagThresholdDetection(
+    const fxos8700MagThresholdConfig_t &config,
+    fxos8700InterruptPin_t intPin) {
+  /* m_ths_ele, m_ths_oae, m_ths_x/y/zefe, m_ths_int_en and m_ths_int_cfg.
+     The routing lives here rather than in CTRL_REG4/CTRL_REG5 */
+  uint8_t cfg = (config.axes & AXIS_ALL) << 3;
+  if (cfg)
+    cfg |= 0x80 | (config.above ? 0x40 : 0x00) | 0x02 | intPin;
+
+  uint16_t ths = (config.threshold > 0x7FFF) ? 0x7FFF : config.threshold;
+  uint8_t msb = ths >> 8;
+  uint8_t lsb = ths & 0xFF;
+  /* m_ths_dbcntm is bit 7 of M_THS_X_MSB */
+  const uint8_t data[] = {(uint8_t)(0x80 | msb), lsb, msb, lsb, msb, lsb,
+                          config.count};
+
+  bool ok = standby(true) &&
+            writeRegisters(FXOS8700_REGISTER_M_THS_X_MSB, data, sizeof(data)) &&
+            writeRegister(FXOS8700_REGISTER_M_THS_CFG, cfg);
+  ok = standby(false) && ok;
+
+  return ok ? FXOS8700_OK : FXOS8700_BUS_ERROR;
 }
 
 /**************************************************************************/
 /*!
-    @brief  Set the sensor mode to hybrid, or accel/mag-only modes
-
-    @param mode The sensor mode to set.
+    @brief  Configures magnetic vector magnitude detection, so the sensor
+            interrupts only when the field moves by more than a set amount
+            from a reference vector.
+
+            The reference is written to M_VECM_INITX/Y/Z, so it can be read
+            back with getMagReferenceVector(). Events are latched until
+            readEvents() reads M_INT_SRC.
+
+    @param config The threshold, debounce count and reference update mode.
+                  A threshold of 0 turns detection off.
+    @param reference The reference vector in raw counts, or NULL to use
+                     the current field.
+    @param intPin The interrupt pin (INT1 or INT2) the vector magnitude
+                  interrupt is routed to.
+
+    @return True if detection was configured, false if the magnetometer is
+            off in the current mode, the current field couldn't be read or
+            a bus transfer failed.
 */
 /**************************************************************************/
-void Adafruit_FXOS8700::setSensorMode(fxos8700SensorMode_t mode) {
-  Adafruit_BusIO_Register MCTRL_REG1(i2c_dev, FXOS8700_REGISTER_MCTRL_REG1);
-  Adafruit_BusIO_Register MCTRL_REG2(i2c_dev, FXOS8700_REGISTER_MCTRL_REG2);
-  Adafruit_BusIO_RegisterBits fs_bits_mreg1(&MCTRL_REG1, 2, 0);
-  Adafruit_BusIO_RegisterBits fs_bit_mreg2(&MCTRL_REG2, 1, 5);
+bool Adafruit_FXOS8700::setMagVectorDetection(
+    const fxos8700MagVectorConfig_t &config,
+    const fxos8700RawData_t *reference, fxos8700InterruptPin_t intPin) {
+  if (config.threshold == 0) {
+    bool ok =
+        standby(true) && writeRegister(FXOS8700_REGISTER_M_VECM_CFG, 0x00);
+    return standby(false) && ok;
+  }
+
+  if (_mode == ACCEL_ONLY_MODE)
+    return false;
 
-  standby(true);
-  fs_bits_mreg1.write(mode);
-  fs_bit_mreg2.write(mode == HYBRID_MODE ? 1 : 0);
-  standby(false);
+  fxos8700RawData_t current;
+  if (!reference) {
+    if (!readRaw(NULL, &current))
+      return false;
+    reference = &current;
+  }
 
-  _mode = mode;
+  /* M_VECM_THS_MSB to M_VECM_INITZ_LSB are contiguous, m_vecm_dbcntm is
+     bit 7 of M_VECM_THS_MSB */
+  uint16_t ths = (config.threshold > 0x1FFF) ? 0x1FFF : config.threshold;
+  const uint8_t data[] = {(uint8_t)(0x80 | (ths >> 8)),
+                          (uint8_t)(ths & 0xFF),
+                          config.count,
+                          (uint8_t)(reference->x >> 8),
+                          (uint8_t)(reference->x & 0xFF),
+                          (uint8_t)(reference->y >> 8),
+                          (uint8_t)(reference->y & 0xFF),
+                          (uint8_t)(reference->z >> 8),
+                          (uint8_t)(reference->z & 0xFF)};
+
+  /* m_vecm_ele, m_vecm_initm to use the INIT registers, m_vecm_updm clear
+     to move the reference at each event, m_vecm_en, m_vecm_int_en and
+     m_vecm_int_cfg */
+  uint8_t cfg = 0x80 | 0x40 | 0x10 | 0x04;
+  if (!config.updateReference)
+    cfg |= 0x20;
+  if (intPin == INT_PIN_1)
+    cfg |= 0x02;
+
+  bool ok =
+      standby(true) &&
+      writeRegisters(FXOS8700_REGISTER_M_VECM_THS_MSB, data, sizeof(data)) &&
+      writeRegister(FXOS8700_REGISTER_M_VECM_CFG, cfg);
+  return standby(false) && ok;
 }
 
 /**************************************************************************/
 /*!
-    @brief  Get the sensor mode (either hybrid, or accel/mag-only).
+    @brief  Reads the reference vector used by magnetic vector magnitude
+            detection.
 
-    @return The sensor mode.
+    @attention
+
+    With updateReference set, the sensor moves its working reference at
+    each event internally, while this returns the reference programmed by
+    setMagVectorDetection().
+
+    @param reference The fxos8700RawData_t to fill with the reference, in
+                     raw counts.
+
+    @return True if the read was successful, otherwise false.
 */
 /**************************************************************************/
-fxos8700SensorMode_t Adafruit_FXOS8700::getSensorMode() { return _mode; }
+bool Adafruit_FXOS8700::getMagReferenceVector(fxos8700RawData_t *reference) {
+  uint8_t buffer[6];
+  if (!readRegisters(FXOS8700_REGISTER_M_VECM_INITX_MSB, buffer,
+                     sizeof(buffer)))
+    return false;
+
+  fxos8700DecodeMag(buffer, reference);
+  return true;
+}
 
 /**************************************************************************/
 /*!
-    @brief  Set the accelerometer full scale range.
+    @brief  Attaches a callback to the host pin wired to an FXOS8700
+            interrupt pin, for the embedded functions configured with the
+            set*Detection() calls.
 
     @attention
 
-    This function resets the lnoise bit to low if a 8G accelerometer range
-    is requested. Otherwise, the active lnoise bit won't allow the sensor
-    to measure past 4G.
+    The callback runs in interrupt context, so it should only set a flag
+    and leave readEvents() to the main loop.
 
-    @param range The accelerometer full scale range to set.
+    @param pin The host pin connected to the FXOS8700 INT pin.
+    @param callback The function to call when the interrupt asserts.
+
+    @return True if the interrupt was attached, otherwise false.
 */
 /**************************************************************************/
-void Adafruit_FXOS8700::setAccelRange(fxos8700AccelRange_t range) {
-  Adafruit_BusIO_Register CTRL_REG1(i2c_dev, FXOS8700_REGISTER_CTRL_REG1);
-  Adafruit_BusIO_Register XYZ_DATA_CFG(i2c_dev, FXOS8700_REGISTER_XYZ_DATA_CFG);
-  Adafruit_BusIO_RegisterBits lnoise_bit(&CTRL_REG1, 1, 2);
-  Adafruit_BusIO_RegisterBits fs_bits(&XYZ_DATA_CFG, 2, 0);
+bool Adafruit_FXOS8700::attachEventInterrupt(uint8_t pin,
+                                             void (*callback)(void)) {
+  if (!callback)
+    return false;
+
+  int irq = digitalPinToInterrupt(pin);
+#ifdef NOT_AN_INTERRUPT
+  if (irq == NOT_AN_INTERRUPT)
+    return false;
+#endif
 
-  standby(true);
-  fs_bits.write(range);
-  if (range == ACCEL_RANGE_8G)
-    lnoise_bit.write(0x00);
-  standby(false);
+  /* The INT pins default to active-low push-pull outputs */
+  pinMode(pin, INPUT);
+  attachInterrupt(irq, callback, FALLING);
 
-  _range = range;
+  return true;
 }
 
 /**************************************************************************/
 /*!
-    @brief  Get the accelerometer full scale range.
+    @brief  Reads which interrupts are pending and the source register of
+            each flagged function.
 
-    @return The accelerometer full scale range.
+            Reading a source register clears its latched event and releases
+            the interrupt pin, so call this once per interrupt. Only the
+            source registers of flagged functions are read, to keep the bus
+            traffic down.
+
+    @param events The fxos8700Events_t to fill in.
+
+    @return True if the read was successful, otherwise false.
 */
 /**************************************************************************/
-fxos8700AccelRange_t Adafruit_FXOS8700::getAccelRange() { return _range; }
+bool Adafruit_FXOS8700::readEvents(fxos8700Events_t *events) {
+  memset(events, 0, sizeof(fxos8700Events_t));
+
+  if (!readRegisters(FXOS8700_REGISTER_INT_SOURCE, &events->sources, 1) ||
+      !readRegisters(FXOS8700_REGISTER_M_INT_SRC, &events->magSources, 1))
+    return false;
+
+  /* Source register of each function flagged */
+  const struct {
+    bool pending;
+    uint8_t reg;
+    uint8_t *value;
+  } reads[] = {
+      {(events->sources & INT_SOURCE_PULSE) != 0, FXOS8700_REGISTER_PULSE_SRC,
+       &events->tap},
+      {(events->sources & INT_SOURCE_FFMT) != 0, FXOS8700_REGISTER_A_FFMT_SRC,
+       &events->freefallMotion},
+      {(events->sources & INT_SOURCE_TRANS) != 0,
+       FXOS8700_REGISTER_TRANSIENT_SRC, &events->transient},
+      {(events->sources & INT_SOURCE_LNDPRT) != 0, FXOS8700_REGISTER_PL_STATUS,
+       &events->orientation},
+      {(events->sources & INT_SOURCE_ASLP) != 0, FXOS8600_REGISTER_SYSMOD,
+       &events->systemMode},
+      {(events->magSources & MAG_INT_SOURCE_THS) != 0,
+       FXOS8700_REGISTER_M_THS_SRC, &events->magThreshold},
+  };
+
+  bool ok = true;
+  for (size_t i = 0; i < sizeof(reads) / sizeof(reads[0]); i++) {
+    if (reads[i].pending && !readRegisters(reads[i].reg, reads[i].value, 1))
+      ok = false;
+  }
+
+  return ok;
+}
 
 /**************************************************************************/
 /*!
-    @brief  Set the FXOS8700's ODR from any sensor mode.
+    @brief  Lets the sensor drop to a lower output data rate and power on
+            its own while idle.
 
-    @param rate The FXOS8700's ODR.
+            The auto-sleep counter puts the sensor to sleep once none of
+            the wake sources has fired for config.sleepDelay, and any of
+            them wakes it back to the normal ODR. Switching happens on the
+            sensor, so there is no standby cycle or bus traffic per
+            transition. Set up the wake source functions (e.g. with
+            setTransientDetection()) as well, a source that isn't
+            configured never fires.
+
+    @attention
+
+    The interrupt enables of the wake sources are set in CTRL_REG4, since a
+    function only wakes the sensor with its interrupt enabled.
+
+    @param config The sleep rate, oversampling, wake sources and delay.
+
+    @return True if auto-sleep was enabled, false if config.sleepRate isn't
+            one of the auto-sleep rates for the current mode or a bus
+            transfer failed.
 */
 /**************************************************************************/
-void Adafruit_FXOS8700::setOutputDataRate(fxos8700ODR_t rate) {
-  Adafruit_BusIO_Register CTRL_REG1(i2c_dev, FXOS8700_REGISTER_CTRL_REG1);
-  Adafruit_BusIO_RegisterBits fs_bits(&CTRL_REG1, 3, 3);
-  bool isRateInMode = false;
-  uint8_t odr;
+bool Adafruit_FXOS8700::enableAutoSleep(
+    const fxos8700AutoSleepConfig_t &config) {
+  uint8_t aslpRate;
+  if (!lookupSleepRate(config.sleepRate, &aslpRate))
+    return false;
 
-  if (_mode == HYBRID_MODE) {
-    // test if rate param belongs in the available hybrid ODR mode options
-    for (int i = 0; i < 8; i++) {
-      if (rate == HYBRID_AVAILABLE_ODRs[i]) {
-        odr = ODR_drBits[i];
-        isRateInMode = true;
-        break;
-      }
-    }
-  } else {
-    // test if rate param belongs in the available accel/mag-only ODR mode
-    // options
-    for (int i = 0; i < 8; i++) {
-      if (rate == ACCEL_MAG_ONLY_AVAILABLE_ODRs[i]) {
-        odr = ODR_drBits[i];
-        isRateInMode = true;
-        break;
-      }
-    }
-  }
+  bool ok = standby(true) && writeAutoSleep(config, aslpRate);
+  return standby(false) && ok;
+}
 
-  if (!isRateInMode) {
-    // requested rate can't be set in current sensor mode, so return
-    // existing rate without setting
-    return;
-  }
+/**************************************************************************/
+/*!
+    @brief  Keeps the sensor awake at the normal output data rate, undoing
+            enableAutoSleep().
 
-  standby(true);
-  CTRL_REG1.write(odr);
-  standby(false);
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
+*/
+/**************************************************************************/
+fxos8700Status_t Adafruit_FXOS8700::disableAutoSleep() {
+  bool ok = standby(true) && clearAutoSleep();
+  ok = standby(false) && ok;
 
-  _rate = rate;
+  return ok ? FXOS8700_OK : FXOS8700_BUS_ERROR;
 }
 
 /**************************************************************************/
 /*!
-    @brief  Get the FXOS8700's Hybrid ODR.
+    @brief  Gets the state the sensor is in, which changes on its own with
+            auto-sleep enabled.
 
-    @return The FXOS8700's Hybrid ODR.
+    @param  effectiveRateHz Set to the rate each enabled sensor is sampled
+                            at in that state, 0 in standby, or NULL.
+
+    @return The sysmod[1:0] state from SYSMOD. STANDBY if the read failed,
+            see getLastError().
 */
 /**************************************************************************/
-fxos8700ODR_t Adafruit_FXOS8700::getOutputDataRate() { return _rate; }
+fxos8700SystemStatus_t
+Adafruit_FXOS8700::getSystemMode(float *effectiveRateHz) {
+  uint8_t sysmod;
+  fxos8700SystemStatus_t mode = STANDBY;
+  if (readRegisters(FXOS8600_REGISTER_SYSMOD, &sysmod, 1))
+    mode = (fxos8700SystemStatus_t)(sysmod & 0x03);
+
+  if (effectiveRateHz) {
+    float hz = 0;
+    if (mode == WAKE)
+      hz = FXOS8700_DR_HZ[(_ctrlReg[0] >> 3) & 0x07];
+    else if (mode == SLEEP)
+      hz = FXOS8700_DR_HZ[((_ctrlReg[0] >> 6) & 0x03) + 4];
+    *effectiveRateHz = (_mode == HYBRID_MODE) ? hz / 2 : hz;
+  }
+
+  return mode;
+}
 
 /**************************************************************************/
 /*!
-    @brief  Set the magnetometer oversampling ratio (OSR)
+    @brief  Lets the sensor lower its own output data rate while idle,
+            using motion to wake.
 
-    @param ratio The magnetometer OSR to set.
+            This is enableAutoSleep() with the transient function as the
+            only wake source and low power oversampling while asleep,
+            with the transient function set up to detect motion on any
+            axis.
+
+    @attention
+
+    This uses the transient function and its interrupt enable.
+
+    @param config The sleep rate, wake threshold and hysteresis to use.
+
+    @return True if adaptive rate was enabled, false if config.sleepRate
+            isn't one of the auto-sleep rates for the current mode or a bus
+            transfer failed.
 */
 /**************************************************************************/
-void Adafruit_FXOS8700::setMagOversamplingRatio(fxos8700MagOSR_t ratio) {
-  Adafruit_BusIO_Register MCTRL_REG1(i2c_dev, FXOS8700_REGISTER_MCTRL_REG1);
-  Adafruit_BusIO_RegisterBits fs_bits_mreg1(&MCTRL_REG1, 3, 2);
-
-  standby(true);
-  fs_bits_mreg1.write(ratio);
-  standby(false);
+bool Adafruit_FXOS8700::enableAdaptiveRate(
+    const fxos8700AdaptiveConfig_t &config) {
+  uint8_t aslpRate;
+  if (!lookupSleepRate(config.sleepRate, &aslpRate))
+    return false;
 
-  _ratio = ratio;
+  const fxos8700AutoSleepConfig_t sleep = {
+      config.sleepRate, config.sleepRatio, ACCEL_OSM_LOW_POWER,
+      WAKE_SOURCE_TRANSIENT, config.sleepDelay};
+
+  /* Transient on x, y and z through the high-pass filter, unlatched. dbcntm
+     clears the debounce counter as soon as the motion stops */
+  const uint8_t transient[] = {
+      (uint8_t)(0x80 | embeddedThreshold(config.wakeThreshold)),
+      config.wakeCount};
+
+  bool ok = standby(true) &&
+            writeRegister(FXOS8700_REGISTER_TRANSIENT_CFG, 0x0E) &&
+            writeRegisters(FXOS8700_REGISTER_TRANSIENT_THS, transient,
+                           sizeof(transient)) &&
+            writeAutoSleep(sleep, aslpRate);
+  return standby(false) && ok;
 }
 
 /**************************************************************************/
 /*!
-    @brief  Get the magnetometer oversampling ratio (OSR).
+    @brief  Keeps the sensor at the normal output data rate, undoing
+            enableAdaptiveRate().
 
-    @return The magnetometer OSR.
+    @return FXOS8700_OK if the setting was written, or FXOS8700_BUS_ERROR
+            if the sensor couldn't be reconfigured.
 */
 /**************************************************************************/
-fxos8700MagOSR_t Adafruit_FXOS8700::getMagOversamplingRatio() { return _ratio; }
+fxos8700Status_t Adafruit_FXOS8700::disableAdaptiveRate() {
+  bool ok = standby(true) &&
+            writeRegister(FXOS8700_REGISTER_TRANSIENT_CFG, 0x00) &&
+            clearAutoSleep();
+  ok = standby(false) && ok;
+
+  return ok ? FXOS8700_OK : FXOS8700_BUS_ERROR;
+}
 
 /**************************************************************************/
 /*!
@@ -587,7 +3175,7 @@ void Adafruit_FXOS8700_Magnetometer::getSensor(sensor_t *sensor) {
 */
 /**************************************************************************/
 bool Adafruit_FXOS8700_Magnetometer::getEvent(sensors_event_t *event) {
-  return _theFXOS8700->getEvent(NULL, event);
+  return _theFXOS8700->getCachedEvent(NULL, event);
 }
 
 /**************************************************************************/
@@ -619,5 +3207,5 @@ void Adafruit_FXOS8700_Accelerometer::getSensor(sensor_t *sensor) {
 */
 /**************************************************************************/
 bool Adafruit_FXOS8700_Accelerometer::getEvent(sensors_event_t *event) {
-  return _theFXOS8700->getEvent(event, NULL);
+  return _theFXOS8700->getCachedEvent(event, NULL);
 }
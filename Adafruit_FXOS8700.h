@@ -5,8 +5,8 @@
  * designed specifically to work with the Adafruit FXOS8700 breakout:
  * https://www.adafruit.com/products/3463
  *
- * These sensors use I2C to communicate, 2 pins (SCL+SDA) are required
- * to interface with the breakout.
+ * These sensors use I2C or SPI to communicate, 2 pins (SCL+SDA) are
+ * required to interface with the breakout over I2C.
  *
  * Adafruit invests time and resources providing this open source code,
  * please support Adafruit and open-source hardware by purchasing
@@ -23,6 +23,7 @@
 
 #include <Adafruit_BusIO_Register.h>
 #include <Adafruit_I2CDevice.h>
+#include <Adafruit_SPIDevice.h>
 #include <Adafruit_Sensor.h>
 #include <Arduino.h>
 
@@ -33,6 +34,12 @@
 // #define FXOS8700_ADDRESS (0x1F) // 0011111
 /** Device ID for this sensor (used as sanity check during init) */
 #define FXOS8700_ID (0xC7) // 1100 0111
+/** Fastest SPI clock the sensor supports, in Hz */
+#define FXOS8700_SPI_MAX_FREQ (1000000)
+#ifndef FXOS8700_ENABLE_STATS
+/** Set to 1 to count bus transactions, see Adafruit_FXOS8700::getStats() */
+#define FXOS8700_ENABLE_STATS (0)
+#endif
 /*=========================================================================*/
 
 /*=========================================================================
@@ -49,10 +56,51 @@ typedef enum {
   FXOS8700_REGISTER_OUT_Y_LSB = 0x04, /**< 0x04 */
   FXOS8700_REGISTER_OUT_Z_MSB = 0x05, /**< 0x05 */
   FXOS8700_REGISTER_OUT_Z_LSB = 0x06, /**< 0x06 */
-  FXOS8600_REGISTER_SYSMOD = 0x0B,    /**< 0x0B */
+  FXOS8700_REGISTER_F_SETUP =
+      0x09, /**< 0x09 (default value = 0b00000000, read/write) */
+  FXOS8600_REGISTER_SYSMOD = 0x0B,     /**< 0x0B */
+  FXOS8700_REGISTER_INT_SOURCE = 0x0C, /**< 0x0C (read only) */
   FXOS8700_REGISTER_WHO_AM_I =
       0x0D, /**< 0x0D (default value = 0b11000111, read only) */
   FXOS8700_REGISTER_XYZ_DATA_CFG = 0x0E, /**< 0x0E */
+  FXOS8700_REGISTER_HP_FILTER_CUTOFF =
+      0x0F, /**< 0x0F (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_PL_STATUS = 0x10,    /**< 0x10 (read only) */
+  FXOS8700_REGISTER_PL_CFG =
+      0x11, /**< 0x11 (default value = 0b10000000, read/write) */
+  FXOS8700_REGISTER_PL_COUNT =
+      0x12, /**< 0x12 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_A_FFMT_CFG =
+      0x15, /**< 0x15 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_A_FFMT_SRC = 0x16, /**< 0x16 (read only) */
+  FXOS8700_REGISTER_A_FFMT_THS =
+      0x17, /**< 0x17 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_A_FFMT_COUNT =
+      0x18, /**< 0x18 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_TRANSIENT_CFG =
+      0x1D, /**< 0x1D (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_TRANSIENT_SRC = 0x1E, /**< 0x1E (read only) */
+  FXOS8700_REGISTER_TRANSIENT_THS =
+      0x1F, /**< 0x1F (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_TRANSIENT_COUNT =
+      0x20, /**< 0x20 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_PULSE_CFG =
+      0x21, /**< 0x21 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_PULSE_SRC = 0x22, /**< 0x22 (read only) */
+  FXOS8700_REGISTER_PULSE_THSX =
+      0x23, /**< 0x23 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_PULSE_THSY =
+      0x24, /**< 0x24 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_PULSE_THSZ =
+      0x25, /**< 0x25 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_PULSE_TMLT =
+      0x26, /**< 0x26 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_PULSE_LTCY =
+      0x27, /**< 0x27 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_PULSE_WIND =
+      0x28, /**< 0x28 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_ASLP_COUNT =
+      0x29, /**< 0x29 (default value = 0b00000000, read/write) */
   FXOS8700_REGISTER_CTRL_REG1 =
       0x2A, /**< 0x2A (default value = 0b00000000, read/write) */
   FXOS8700_REGISTER_CTRL_REG2 =
@@ -63,6 +111,12 @@ typedef enum {
       0x2D, /**< 0x2D (default value = 0b00000000, read/write) */
   FXOS8700_REGISTER_CTRL_REG5 =
       0x2E, /**< 0x2E (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_OFF_X =
+      0x2F, /**< 0x2F (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_OFF_Y =
+      0x30, /**< 0x30 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_OFF_Z =
+      0x31, /**< 0x31 (default value = 0b00000000, read/write) */
   FXOS8700_REGISTER_MSTATUS = 0x32,    /**< 0x32 */
   FXOS8700_REGISTER_MOUT_X_MSB = 0x33, /**< 0x33 */
   FXOS8700_REGISTER_MOUT_X_LSB = 0x34, /**< 0x34 */
@@ -70,15 +124,110 @@ typedef enum {
   FXOS8700_REGISTER_MOUT_Y_LSB = 0x36, /**< 0x36 */
   FXOS8700_REGISTER_MOUT_Z_MSB = 0x37, /**< 0x37 */
   FXOS8700_REGISTER_MOUT_Z_LSB = 0x38, /**< 0x38 */
+  FXOS8700_REGISTER_MOFF_X_MSB = 0x3F, /**< 0x3F */
+  FXOS8700_REGISTER_MOFF_X_LSB = 0x40, /**< 0x40 */
+  FXOS8700_REGISTER_MOFF_Y_MSB = 0x41, /**< 0x41 */
+  FXOS8700_REGISTER_MOFF_Y_LSB = 0x42, /**< 0x42 */
+  FXOS8700_REGISTER_MOFF_Z_MSB = 0x43, /**< 0x43 */
+  FXOS8700_REGISTER_MOFF_Z_LSB = 0x44, /**< 0x44 */
+  FXOS8700_REGISTER_MMAX_X_MSB = 0x45, /**< 0x45 */
+  FXOS8700_REGISTER_MMAX_X_LSB = 0x46, /**< 0x46 */
+  FXOS8700_REGISTER_MMAX_Y_MSB = 0x47, /**< 0x47 */
+  FXOS8700_REGISTER_MMAX_Y_LSB = 0x48, /**< 0x48 */
+  FXOS8700_REGISTER_MMAX_Z_MSB = 0x49, /**< 0x49 */
+  FXOS8700_REGISTER_MMAX_Z_LSB = 0x4A, /**< 0x4A */
+  FXOS8700_REGISTER_MMIN_X_MSB = 0x4B, /**< 0x4B */
+  FXOS8700_REGISTER_MMIN_X_LSB = 0x4C, /**< 0x4C */
+  FXOS8700_REGISTER_MMIN_Y_MSB = 0x4D, /**< 0x4D */
+  FXOS8700_REGISTER_MMIN_Y_LSB = 0x4E, /**< 0x4E */
+  FXOS8700_REGISTER_MMIN_Z_MSB = 0x4F, /**< 0x4F */
+  FXOS8700_REGISTER_MMIN_Z_LSB = 0x50, /**< 0x50 */
+  FXOS8700_REGISTER_M_THS_CFG =
+      0x52, /**< 0x52 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_THS_SRC = 0x53, /**< 0x53 (read only) */
+  FXOS8700_REGISTER_M_THS_X_MSB =
+      0x54, /**< 0x54 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_THS_X_LSB =
+      0x55, /**< 0x55 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_THS_Y_MSB =
+      0x56, /**< 0x56 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_THS_Y_LSB =
+      0x57, /**< 0x57 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_THS_Z_MSB =
+      0x58, /**< 0x58 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_THS_Z_LSB =
+      0x59, /**< 0x59 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_THS_COUNT =
+      0x5A, /**< 0x5A (default value = 0b00000000, read/write) */
   FXOS8700_REGISTER_MCTRL_REG1 =
       0x5B, /**< 0x5B (default value = 0b00000000, read/write) */
   FXOS8700_REGISTER_MCTRL_REG2 =
       0x5C, /**< 0x5C (default value = 0b00000000, read/write) */
   FXOS8700_REGISTER_MCTRL_REG3 =
       0x5D, /**< 0x5D (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_INT_SRC = 0x5E, /**< 0x5E (read only) */
+  FXOS8700_REGISTER_M_VECM_CFG =
+      0x69, /**< 0x69 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_VECM_THS_MSB =
+      0x6A, /**< 0x6A (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_VECM_THS_LSB =
+      0x6B, /**< 0x6B (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_VECM_CNT =
+      0x6C, /**< 0x6C (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_VECM_INITX_MSB =
+      0x6D, /**< 0x6D (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_VECM_INITX_LSB =
+      0x6E, /**< 0x6E (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_VECM_INITY_MSB =
+      0x6F, /**< 0x6F (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_VECM_INITY_LSB =
+      0x70, /**< 0x70 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_VECM_INITZ_MSB =
+      0x71, /**< 0x71 (default value = 0b00000000, read/write) */
+  FXOS8700_REGISTER_M_VECM_INITZ_LSB =
+      0x72, /**< 0x72 (default value = 0b00000000, read/write) */
 } fxos8700Registers_t;
 /*=========================================================================*/
 
+/*=========================================================================
+    DRIVER STATUS
+    -----------------------------------------------------------------------*/
+/*!
+    Result of a driver operation that can fail or complete later
+*/
+typedef enum {
+  FXOS8700_OK,         /**< Operation completed */
+  FXOS8700_PENDING,    /**< Operation is still in progress */
+  FXOS8700_TIMEOUT,    /**< Operation didn't complete before its deadline */
+  FXOS8700_BUS_ERROR,  /**< A bus transfer failed */
+  FXOS8700_UNSUPPORTED /**< Setting isn't available in the current mode */
+} fxos8700Status_t;
+
+/** Default deadline for a standby/active transition, longer than one sample
+ * period at the slowest ODR */
+#define FXOS8700_STANDBY_TIMEOUT_US (1500000UL)
+/** Interval between SYSMOD polls while waiting on a blocking transition */
+#define FXOS8700_STANDBY_POLL_US (100)
+
+/*!
+    @brief  How failed bus transfers are retried and recovered from, see
+            Adafruit_FXOS8700::setRetryPolicy()
+*/
+typedef struct {
+  uint8_t attempts;     /**< Tries per transfer including the first, 1 for
+                             no retries */
+  uint32_t deadline_us; /**< No retry is started once this long has passed
+                             since the first try, 0 for no deadline */
+  uint8_t recoverAfter; /**< Consecutive failed transfers before recover()
+                             is called automatically, at the start of the
+                             next read, 0 for never */
+} fxos8700RetryPolicy_t;
+
+/** Retry policy used until setRetryPolicy() is called: no retries and no
+ * automatic recovery */
+const fxos8700RetryPolicy_t FXOS8700_DEFAULT_RETRY_POLICY = {1, 0, 0};
+/*=========================================================================*/
+
 /*=========================================================================
     OPTIONAL SENSOR MODE SETTINGS
     -----------------------------------------------------------------------*/
@@ -102,6 +251,170 @@ typedef enum {
   MAG_ONLY_MODE = 0b01,   /**< m_hms[1:0] = 0b01. Mag-only mode */
   HYBRID_MODE = 0b11      /**< m_hms[1:0] = 0b11. Hybrid mode */
 } fxos8700SensorMode_t;
+
+/*!
+    Sensor reported by the single event getEvent(sensors_event_t *) in
+    hybrid mode. Whichever is reported, both sensors come from one 13 byte
+    burst, since hyb_autoinc_mode in MCTRL_REG2 makes a read from STATUS
+    jump from OUT_Z_LSB (0x06) to MOUT_X_MSB (0x33). The sensor that isn't
+    reported stays cached for the split Adafruit_Sensor objects
+*/
+typedef enum {
+  HYBRID_EVENT_ACCEL,    /**< Always report the accelerometer */
+  HYBRID_EVENT_MAG,      /**< Always report the magnetometer */
+  HYBRID_EVENT_ALTERNATE /**< Alternate, starting with the accelerometer,
+                              both events of a pair from the same burst */
+} fxos8700HybridEvent_t;
+/*=========================================================================*/
+
+/*=========================================================================
+    OPTIONAL FIFO SETTINGS
+    -----------------------------------------------------------------------*/
+/*!
+    FIFO buffer mode for the accelerometer. When the FIFO is enabled, the
+    STATUS register (0x00) reads back as F_STATUS. Sent to the f_mode[1:0]
+    bits in FXOS8700_REGISTER_F_SETUP
+*/
+typedef enum {
+  FIFO_MODE_DISABLED = 0b00, /**< f_mode[1:0] = 0b00. FIFO disabled */
+  FIFO_MODE_CIRCULAR = 0b01, /**< f_mode[1:0] = 0b01. Circular buffer */
+  FIFO_MODE_STOP = 0b10,     /**< f_mode[1:0] = 0b10. Stop when full */
+  FIFO_MODE_TRIGGER = 0b11   /**< f_mode[1:0] = 0b11. Trigger mode */
+} fxos8700FifoMode_t;
+
+/** Number of samples held by the accelerometer FIFO */
+#define FXOS8700_FIFO_SIZE (32)
+/*=========================================================================*/
+
+/*=========================================================================
+    OPTIONAL INTERRUPT SETTINGS
+    -----------------------------------------------------------------------*/
+/*!
+    Interrupt output pin that an interrupt source is routed to. Sent to the
+    matching int_cfg bit in FXOS8700_REGISTER_CTRL_REG5
+*/
+typedef enum {
+  INT_PIN_2 = 0x00, /**< int_cfg = 0. Route the interrupt to INT2 */
+  INT_PIN_1 = 0x01  /**< int_cfg = 1. Route the interrupt to INT1 */
+} fxos8700InterruptPin_t;
+
+/*!
+    Accelerometer interrupt sources, as flagged in
+    FXOS8700_REGISTER_INT_SOURCE. The same bits enable and route each source
+    in CTRL_REG4 and CTRL_REG5
+*/
+typedef enum {
+  INT_SOURCE_DRDY = 0x01,   /**< src_drdy. Data ready */
+  INT_SOURCE_A_VECM = 0x02, /**< src_a_vecm. Accel vector magnitude */
+  INT_SOURCE_FFMT = 0x04,   /**< src_ffmt. Freefall/motion */
+  INT_SOURCE_PULSE = 0x08,  /**< src_pulse. Tap/double tap */
+  INT_SOURCE_LNDPRT = 0x10, /**< src_lndprt. Portrait/landscape change */
+  INT_SOURCE_TRANS = 0x20,  /**< src_trans. Transient */
+  INT_SOURCE_FIFO = 0x40,   /**< src_fifo. FIFO watermark/overflow */
+  INT_SOURCE_ASLP = 0x80    /**< src_aslp. Auto-sleep/wake transition */
+} fxos8700InterruptSource_t;
+
+/*!
+    Magnetometer interrupt sources, as flagged in
+    FXOS8700_REGISTER_M_INT_SRC
+*/
+typedef enum {
+  MAG_INT_SOURCE_DRDY = 0x01, /**< src_m_drdy. Data ready */
+  MAG_INT_SOURCE_VECM = 0x02, /**< src_m_vecm. Vector magnitude */
+  MAG_INT_SOURCE_THS = 0x04   /**< src_m_ths. Threshold */
+} fxos8700MagInterruptSource_t;
+/*=========================================================================*/
+
+/*=========================================================================
+    OPTIONAL EMBEDDED FUNCTION SETTINGS
+    -----------------------------------------------------------------------*/
+/*!
+    Axes an embedded function watches, combined as a bitmask. A mask of 0
+    turns the function off
+*/
+typedef enum {
+  AXIS_X = 0x01,  /**< X axis */
+  AXIS_Y = 0x02,  /**< Y axis */
+  AXIS_Z = 0x04,  /**< Z axis */
+  AXIS_ALL = 0x07 /**< X, Y and Z axes */
+} fxos8700Axis_t;
+
+/** Milli-g per threshold step of the pulse, FFMT and transient functions */
+#define FXOS8700_EMBEDDED_THS_MG (63)
+
+/*!
+    @brief  Tap (pulse) detection settings. The time settings are in
+            register counts, whose length depends on the ODR, see the
+            PULSE_TMLT, PULSE_LTCY and PULSE_WIND registers in the datasheet
+*/
+typedef struct {
+  uint8_t axes;       /**< fxos8700Axis_t mask, 0 turns detection off */
+  bool doubleTap;     /**< Detect double taps as well as single taps */
+  uint16_t threshold; /**< Tap threshold in mg, 63mg steps */
+  uint8_t timeLimit;  /**< Longest a tap can stay above the threshold */
+  uint8_t latency;    /**< Time after a tap before another is detected */
+  uint8_t window;     /**< Time after the latency for the second tap */
+} fxos8700TapConfig_t;
+
+/*!
+    @brief  Freefall or motion (FFMT) detection settings
+*/
+typedef struct {
+  uint8_t axes;       /**< fxos8700Axis_t mask, 0 turns detection off */
+  bool motion;        /**< True for motion (any axis above threshold),
+                           false for freefall (all axes below threshold) */
+  uint16_t threshold; /**< Threshold in mg, 63mg steps */
+  uint8_t count;      /**< Samples the condition must hold for */
+} fxos8700FreefallMotionConfig_t;
+
+/*!
+    @brief  Transient (high-pass filtered motion) detection settings
+*/
+typedef struct {
+  uint8_t axes;       /**< fxos8700Axis_t mask, 0 turns detection off */
+  uint16_t threshold; /**< Threshold in mg, 63mg steps */
+  uint8_t count;      /**< Samples the condition must hold for */
+} fxos8700TransientConfig_t;
+
+/*!
+    @brief  Magnetic threshold (M_THS) detection settings
+*/
+typedef struct {
+  uint8_t axes;       /**< fxos8700Axis_t mask, 0 turns detection off */
+  bool above;         /**< True for any axis above the threshold, false
+                           for all axes below it */
+  uint16_t threshold; /**< Threshold in raw counts (0.1uT), up to 0x7FFF */
+  uint8_t count;      /**< Samples the condition must hold for */
+} fxos8700MagThresholdConfig_t;
+
+/*!
+    @brief  Magnetic vector magnitude (M_VECM) detection settings. An event
+            is flagged when the magnitude of the difference between the
+            field and a reference vector exceeds the threshold
+*/
+typedef struct {
+  uint16_t threshold;   /**< Change in raw counts (0.1uT), up to 0x1FFF,
+                             0 turns detection off */
+  uint8_t count;        /**< Samples the change must hold for */
+  bool updateReference; /**< Move the reference to the field at each event,
+                             so every event reports a fresh change */
+} fxos8700MagVectorConfig_t;
+
+/*!
+    @brief  Decoded interrupt state, see Adafruit_FXOS8700::readEvents().
+            Each source register is only read, and so cleared, if its
+            function is flagged, otherwise it reads as 0
+*/
+typedef struct {
+  uint8_t sources;        /**< INT_SOURCE, fxos8700InterruptSource_t bits */
+  uint8_t magSources;     /**< M_INT_SRC, fxos8700MagInterruptSource_t bits */
+  uint8_t tap;            /**< PULSE_SRC, bit 3 (dpe) set for a double tap */
+  uint8_t freefallMotion; /**< A_FFMT_SRC */
+  uint8_t transient;      /**< TRANSIENT_SRC */
+  uint8_t orientation;    /**< PL_STATUS, lapo[1:0] in bits 2:1 */
+  uint8_t magThreshold;   /**< M_THS_SRC */
+  uint8_t systemMode;     /**< SYSMOD, fxos8700SystemStatus_t in bits 1:0 */
+} fxos8700Events_t;
 /*=========================================================================*/
 
 /*=========================================================================
@@ -170,6 +483,28 @@ const uint16_t ODR_drBits[] = {
     0x30, /**< dr=0b110. 6.25Hz accel/mag-only modes, 3.125Hz hyrbid mode */
     0x38, /**< dr=0b111. 1.5625Hz accel/mag-only modes, 0.7813Hz hyrbid mode */
 };
+
+/** Marks a rate that isn't available in a mode in FXOS8700_ODR_DR_BITS */
+#define FXOS8700_ODR_UNSUPPORTED (0xFF)
+
+/*!
+    dr[2:0] bits, shifted into their CTRL_REG1 position, indexed by
+    [mode == HYBRID_MODE][fxos8700ODR_t]. FXOS8700_ODR_UNSUPPORTED where the
+    rate isn't available in that mode
+*/
+constexpr uint8_t FXOS8700_ODR_DR_BITS[2][11] = {
+    /* accel/mag-only modes */
+    {0x00, 0x08, 0x10, 0x18, 0x20, 0xFF, 0x28, 0x30, 0xFF, 0x38, 0xFF},
+    /* hybrid mode */
+    {0xFF, 0x00, 0x08, 0x10, 0x18, 0x20, 0xFF, 0x28, 0x30, 0xFF, 0x38},
+};
+
+/*!
+    Output data rate in Hz in accel/mag-only modes, indexed by dr[2:0].
+    Hybrid mode alternates the two sensors, so each runs at half this rate
+*/
+constexpr float FXOS8700_DR_HZ[8] = {800.0F, 400.0F, 200.0F, 100.0F,
+                                     50.0F,  12.5F,  6.25F,  1.5625F};
 /*=========================================================================*/
 
 /*=========================================================================
@@ -185,6 +520,27 @@ typedef enum {
 } fxos8700AccelRange_t;
 /*=========================================================================*/
 
+/*=========================================================================
+    OPTIONAL HIGH-PASS FILTER SETTINGS
+    -----------------------------------------------------------------------*/
+/*!
+    Accelerometer high-pass filter cutoff, sel[1:0] in HP_FILTER_CUTOFF.
+    The frequencies are those of the high resolution oversampling mode the
+    driver runs in, where they don't depend on the ODR
+*/
+typedef enum {
+  HPF_CUTOFF_16HZ = 0x00, /**< 16Hz cutoff */
+  HPF_CUTOFF_8HZ = 0x01,  /**< 8Hz cutoff */
+  HPF_CUTOFF_4HZ = 0x02,  /**< 4Hz cutoff */
+  HPF_CUTOFF_2HZ = 0x03   /**< 2Hz cutoff */
+} fxos8700HighPassCutoff_t;
+
+/** Milli-g per LSB of the OFF_X/Y/Z accelerometer offset registers */
+#define FXOS8700_ACCEL_OFFSET_MG (2.0F)
+/** Samples averaged by Adafruit_FXOS8700::calibrateAccelOffsets() */
+#define FXOS8700_ACCEL_CALIBRATION_SAMPLES (32)
+/*=========================================================================*/
+
 /*=========================================================================
     OPTIONAL MAGNETOMETER OVERSAMPLING SETTINGS
     -----------------------------------------------------------------------*/
@@ -203,6 +559,101 @@ typedef enum {
 } fxos8700MagOSR_t;
 /*=========================================================================*/
 
+/*=========================================================================
+    OPTIONAL AUTO-SLEEP SETTINGS
+    -----------------------------------------------------------------------*/
+/** Milliseconds per ASLP_COUNT step */
+#define FXOS8700_ASLP_COUNT_MS (320)
+
+/*!
+    Accelerometer oversampling modes, sent to smods[1:0] in CTRL_REG2 for
+    the sleep state
+*/
+typedef enum {
+  ACCEL_OSM_NORMAL = 0x00,          /**< Normal */
+  ACCEL_OSM_LOW_NOISE_POWER = 0x01, /**< Low noise, low power */
+  ACCEL_OSM_HIGH_RESOLUTION = 0x02, /**< High resolution */
+  ACCEL_OSM_LOW_POWER = 0x03        /**< Low power */
+} fxos8700OversamplingMode_t;
+
+/*!
+    Embedded functions that wake the sensor from auto-sleep, the wake bits
+    of CTRL_REG3 combined as a bitmask. Any activity of a wake source also
+    restarts the sleep countdown
+*/
+typedef enum {
+  WAKE_SOURCE_FFMT = 0x08,        /**< wake_ffmt. Freefall/motion */
+  WAKE_SOURCE_PULSE = 0x10,       /**< wake_pulse. Tap */
+  WAKE_SOURCE_ORIENTATION = 0x20, /**< wake_lndprt. Orientation change */
+  WAKE_SOURCE_TRANSIENT = 0x40,   /**< wake_trans. Transient */
+  WAKE_SOURCE_ALL = 0x78          /**< All of the above */
+} fxos8700WakeSource_t;
+
+/*!
+    @brief  Auto-sleep settings, see Adafruit_FXOS8700::enableAutoSleep()
+*/
+typedef struct {
+  fxos8700ODR_t sleepRate;              /**< ODR while asleep: 50, 12.5, 6.25
+                                             or 1.5625Hz, or in hybrid mode
+                                             25, 6.25, 3.125 or 0.7813Hz */
+  fxos8700MagOSR_t sleepRatio;          /**< Magnetometer OSR while asleep */
+  fxos8700OversamplingMode_t sleepMode; /**< Accelerometer oversampling
+                                             while asleep */
+  uint8_t wakeSources;                  /**< fxos8700WakeSource_t mask */
+  uint32_t sleepDelay;                  /**< Time without wake source
+                                             activity before sleeping in ms,
+                                             320ms steps up to 81600ms */
+} fxos8700AutoSleepConfig_t;
+/*=========================================================================*/
+
+/*=========================================================================
+    OPTIONAL ADAPTIVE RATE SETTINGS
+    -----------------------------------------------------------------------*/
+
+/*!
+    @brief  Adaptive output data rate settings, see
+            Adafruit_FXOS8700::enableAdaptiveRate()
+
+            The sensor runs at the normal ODR while moving and drops to
+            sleepRate once no motion has been seen for sleepDelay. Motion is
+            high-pass filtered acceleration beyond wakeThreshold on any axis
+            for wakeCount samples in a row. The gap between the long
+            sleepDelay and the short wakeCount debounce is the hysteresis.
+*/
+typedef struct {
+  fxos8700ODR_t sleepRate;     /**< ODR while idle: 50, 12.5, 6.25 or
+                                    1.5625Hz, or in hybrid mode 25, 6.25,
+                                    3.125 or 0.7813Hz */
+  fxos8700MagOSR_t sleepRatio; /**< Magnetometer OSR while idle */
+  uint16_t wakeThreshold;      /**< Motion threshold in mg, 63mg steps up to
+                                    8001mg */
+  uint8_t wakeCount;           /**< Samples beyond the threshold needed to
+                                    wake, counted at the current ODR */
+  uint32_t sleepDelay;         /**< Time without motion before sleeping in
+                                    ms, 320ms steps up to 81600ms */
+} fxos8700AdaptiveConfig_t;
+
+/*!
+    Adaptive rate settings: 6.25Hz and mag OSR 0 while idle, woken by 126mg
+    of motion for 2 samples, asleep after 5s without motion
+*/
+const fxos8700AdaptiveConfig_t FXOS8700_DEFAULT_ADAPTIVE_CONFIG = {
+    ODR_6_25HZ, MAG_OSR_0, 126, 2, 5000};
+/*=========================================================================*/
+
+/*=========================================================================
+    SENSITIVITY
+    -----------------------------------------------------------------------*/
+/** Macro for mg per LSB at +/- 2g sensitivity (1 LSB = 0.000244mg) */
+#define ACCEL_MG_LSB_2G (0.000244F)
+/** Macro for mg per LSB at +/- 4g sensitivity (1 LSB = 0.000488mg) */
+#define ACCEL_MG_LSB_4G (0.000488F)
+/** Macro for mg per LSB at +/- 8g sensitivity (1 LSB = 0.000976mg) */
+#define ACCEL_MG_LSB_8G (0.000976F)
+/** Macro for micro tesla (uT) per LSB (1 LSB = 0.1uT) */
+#define MAG_UT_LSB (0.1F)
+/*=========================================================================*/
+
 /*=========================================================================
     RAW 3DOF SENSOR DATA TYPE
     -----------------------------------------------------------------------*/
@@ -214,6 +665,282 @@ typedef struct {
   int16_t y; /**< Raw int16_t value from the y axis */
   int16_t z; /**< Raw int16_t value from the z axis */
 } fxos8700RawData_t;
+
+/*!
+    @brief  Decodes a big-endian, left-aligned 14-bit accelerometer sample.
+    @param  buffer Six bytes read from OUT_X_MSB onwards.
+    @param  accel The fxos8700RawData_t to fill in. This may overlay buffer,
+            each axis is only written after its own two bytes are read.
+*/
+inline void fxos8700DecodeAccel(const uint8_t *buffer,
+                                fxos8700RawData_t *accel) {
+  /* Note, accel data is 14-bit and left-aligned, so we shift two bit right */
+  accel->x = (int16_t)((buffer[0] << 8) | buffer[1]) >> 2;
+  accel->y = (int16_t)((buffer[2] << 8) | buffer[3]) >> 2;
+  accel->z = (int16_t)((buffer[4] << 8) | buffer[5]) >> 2;
+}
+
+/*!
+    @brief  Decodes a big-endian 16-bit magnetometer sample.
+    @param  buffer Six bytes read from MOUT_X_MSB onwards.
+    @param  mag The fxos8700RawData_t to fill in.
+*/
+inline void fxos8700DecodeMag(const uint8_t *buffer, fxos8700RawData_t *mag) {
+  mag->x = (int16_t)((buffer[0] << 8) | buffer[1]);
+  mag->y = (int16_t)((buffer[2] << 8) | buffer[3]);
+  mag->z = (int16_t)((buffer[4] << 8) | buffer[5]);
+}
+
+/*!
+    @brief  Fixed-point (integer) values from a 3dof sensor.
+*/
+typedef struct {
+  int32_t x; /**< Fixed-point int32_t value from the x axis */
+  int32_t y; /**< Fixed-point int32_t value from the y axis */
+  int32_t z; /**< Fixed-point int32_t value from the z axis */
+} fxos8700FixedData_t;
+
+/*!
+    Fixed-point output formats for the accelerometer, used on targets
+    without an FPU
+*/
+typedef enum {
+  ACCEL_FIXED_MILLI_G, /**< Integer milli-g */
+  ACCEL_FIXED_Q16      /**< Q16.16 m/s^2 */
+} fxos8700FixedFormat_t;
+/*=========================================================================*/
+
+/*=========================================================================
+    SENSOR CONFIGURATION
+    -----------------------------------------------------------------------*/
+/*!
+    @brief  Complete sensor configuration, applied in a single standby/active
+            cycle by Adafruit_FXOS8700::applyConfig()
+*/
+typedef struct {
+  fxos8700SensorMode_t mode;  /**< Hybrid, or accel/mag-only mode */
+  fxos8700AccelRange_t range; /**< Accelerometer full scale range */
+  fxos8700ODR_t rate;         /**< Output data rate, must suit the mode */
+  fxos8700MagOSR_t ratio;     /**< Magnetometer oversampling ratio */
+  bool lowNoise;              /**< Low noise mode, ignored in 8g range */
+} fxos8700Config_t;
+
+/*!
+    Configuration set by begin(): hybrid mode, +/- 2g, 100Hz ODR, mag OSR 7
+    and low noise
+*/
+const fxos8700Config_t FXOS8700_DEFAULT_CONFIG = {
+    HYBRID_MODE, ACCEL_RANGE_2G, ODR_100HZ, MAG_OSR_7, true};
+/*=========================================================================*/
+
+/*=========================================================================
+    SAMPLE BUFFERING
+    -----------------------------------------------------------------------*/
+/*!
+    @brief  A timestamped raw sample from both sensors.
+*/
+typedef struct {
+  uint32_t timestamp;      /**< micros() when the sample was read */
+  fxos8700RawData_t accel; /**< Raw accelerometer counts */
+  fxos8700RawData_t mag;   /**< Raw magnetometer counts */
+  uint8_t status; /**< STATUS byte (M_DR_STATUS in mag-only mode), bit 7
+                     (zyxow) is set if a sample was overwritten unread */
+} fxos8700Sample_t;
+
+/*!
+    @brief  Fixed-capacity, statically allocated ring buffer of samples.
+
+            Intended for one producer (e.g. a data-ready driven read path)
+            and one consumer. Besides the samples it counts how often the
+            sensor overwrote a sample before it was read (zyxow in STATUS)
+            and how many samples were dropped because the buffer was full.
+
+    @attention
+
+    The indices are 16-bit, so on 8-bit AVR wrap pop() in
+    noInterrupts()/interrupts() if push() runs from an interrupt.
+
+    @tparam N The number of samples the buffer can hold.
+*/
+template <uint16_t N> class Adafruit_FXOS8700_SampleBuffer {
+public:
+  /*!
+      @brief  Adds a sample, counting a sensor overrun if its status byte
+              has zyxow set.
+      @param  sample The sample to add.
+      @return True if the sample was stored, false if the buffer was full.
+  */
+  bool push(const fxos8700Sample_t &sample) {
+    if (sample.status & 0x80)
+      _overruns++;
+
+    uint16_t next = (_head == N) ? 0 : _head + 1;
+    if (next == _tail) {
+      _dropped++;
+      return false;
+    }
+
+    _samples[_head] = sample;
+    _head = next;
+    return true;
+  }
+
+  /*!
+      @brief  Removes the oldest sample.
+      @param  sample The fxos8700Sample_t to copy the sample into.
+      @return True if a sample was returned, false if the buffer was empty.
+  */
+  bool pop(fxos8700Sample_t *sample) {
+    if (_tail == _head)
+      return false;
+
+    *sample = _samples[_tail];
+    _tail = (_tail == N) ? 0 : _tail + 1;
+    return true;
+  }
+
+  /*! @brief  Gets the number of samples waiting in the buffer.
+      @return The number of samples. */
+  uint16_t available() const {
+    uint16_t head = _head;
+    uint16_t tail = _tail;
+    return (head >= tail) ? head - tail : head + N + 1 - tail;
+  }
+
+  /*! @brief  Gets the buffer capacity.
+      @return The number of samples the buffer can hold. */
+  uint16_t capacity() const { return N; }
+
+  /*! @brief  Gets the number of samples the sensor overwrote unread.
+      @return The overrun count. */
+  uint32_t overruns() const { return _overruns; }
+
+  /*! @brief  Gets the number of samples dropped because the buffer was full.
+      @return The dropped sample count. */
+  uint32_t dropped() const { return _dropped; }
+
+  /*! @brief  Empties the buffer and resets the counters. */
+  void clear() {
+    _head = 0;
+    _tail = 0;
+    _overruns = 0;
+    _dropped = 0;
+  }
+
+private:
+  /* One slot is kept free to tell a full buffer from an empty one */
+  fxos8700Sample_t _samples[N + 1];
+  volatile uint16_t _head = 0;
+  volatile uint16_t _tail = 0;
+  volatile uint32_t _overruns = 0;
+  volatile uint32_t _dropped = 0;
+};
+/*=========================================================================*/
+
+/*=========================================================================
+    TIMING
+    -----------------------------------------------------------------------*/
+/*!
+    Clock used for sensor event timestamps
+*/
+typedef enum {
+  TIMESTAMP_MILLIS, /**< millis(), the Adafruit_Sensor default */
+  TIMESTAMP_MICROS, /**< micros() */
+  TIMESTAMP_CUSTOM  /**< Clock passed to setTimestampClock() */
+} fxos8700TimestampSource_t;
+
+/*!
+    @brief  Running statistics of the interval between sensor reads, in
+            microseconds. max - min gives the peak-to-peak jitter.
+*/
+typedef struct {
+  uint32_t count; /**< Number of intervals measured */
+  uint32_t min;   /**< Shortest interval */
+  uint32_t max;   /**< Longest interval */
+  uint32_t mean;  /**< Mean interval */
+} fxos8700IntervalStats_t;
+/*=========================================================================*/
+
+/*=========================================================================
+    BUS STATISTICS
+    -----------------------------------------------------------------------*/
+/*!
+    @brief  Bus usage counters, maintained when FXOS8700_ENABLE_STATS is 1
+*/
+typedef struct {
+  uint32_t transactions;  /**< Bus transactions issued */
+  uint32_t bytesWritten;  /**< Bytes written, including register addresses */
+  uint32_t bytesRead;     /**< Bytes read */
+  uint32_t busMicros;     /**< Time spent in blocking transfers */
+  uint32_t failures;      /**< Transactions that failed */
+  uint32_t standbyCycles; /**< Transitions into standby */
+  uint32_t retries;       /**< Transfers retried after a failure */
+  uint32_t recoveries;    /**< Calls to recover() */
+} fxos8700Stats_t;
+/*=========================================================================*/
+
+/*=========================================================================
+    ASYNCHRONOUS TRANSPORT
+    -----------------------------------------------------------------------*/
+/*!
+    @brief  Hooks for a non-blocking bus transfer (e.g. DMA), used by
+            Adafruit_FXOS8700::startRead()
+*/
+typedef struct {
+  /** Starts reading len bytes from register reg of the device at I2C
+      address addr into buffer. Returns false if the transfer wasn't
+      started */
+  bool (*startRead)(void *context, uint8_t addr, uint8_t reg,
+                    uint8_t *buffer, size_t len);
+  /** Returns FXOS8700_PENDING while the transfer is in progress, then
+      FXOS8700_OK or FXOS8700_BUS_ERROR */
+  fxos8700Status_t (*poll)(void *context);
+  /** Passed back to the hooks, e.g. a pointer to the platform's DMA
+      state */
+  void *context;
+} fxos8700AsyncTransport_t;
+/*=========================================================================*/
+
+/*=========================================================================
+    REGISTER TRANSPORT
+    -----------------------------------------------------------------------*/
+/**************************************************************************/
+/*!
+    @brief  Register access used in place of the I2C or SPI bus after
+            Adafruit_FXOS8700::begin_Transport(), e.g. to run the driver
+            against Adafruit_FXOS8700_Mock or over a bus BusIO doesn't
+            cover. Bursts follow the sensor's own address auto-increment.
+*/
+/**************************************************************************/
+class Adafruit_FXOS8700_Transport {
+public:
+  virtual ~Adafruit_FXOS8700_Transport() {}
+
+  /*!
+      @brief  Starts the transport, called by begin_Transport() and again
+              by Adafruit_FXOS8700::recover().
+      @return True if the transport is ready, otherwise false.
+  */
+  virtual bool begin() { return true; }
+
+  /*!
+      @brief  Burst reads consecutive registers.
+      @param  reg The first register address.
+      @param  buffer The buffer the register values are read into.
+      @param  len The number of registers to read.
+      @return True if the transfer was successful, otherwise false.
+  */
+  virtual bool read(uint8_t reg, uint8_t *buffer, size_t len) = 0;
+
+  /*!
+      @brief  Burst writes consecutive registers.
+      @param  reg The first register address.
+      @param  buffer The register values to write.
+      @param  len The number of registers to write.
+      @return True if the transfer was successful, otherwise false.
+  */
+  virtual bool write(uint8_t reg, const uint8_t *buffer, size_t len) = 0;
+};
 /*=========================================================================*/
 
 class Adafruit_FXOS8700;
@@ -262,12 +989,57 @@ public:
   Adafruit_FXOS8700(int32_t accelSensorID = -1, int32_t magSensorID = -1);
   ~Adafruit_FXOS8700();
   bool begin(uint8_t addr = 0x1F, TwoWire *wire = &Wire);
+  bool begin_SPI(uint8_t cs_pin, SPIClass *theSPI = &SPI,
+                 uint32_t frequency = FXOS8700_SPI_MAX_FREQ);
+  bool begin_Transport(Adafruit_FXOS8700_Transport *transport);
 
   bool getEvent(sensors_event_t *accel);
   void getSensor(sensor_t *singleSensorEvent);
   bool getEvent(sensors_event_t *accel, sensors_event_t *mag);
   void getSensor(sensor_t *accel, sensor_t *mag);
-  void standby(boolean standby);
+  bool readRaw(fxos8700RawData_t *accel, fxos8700RawData_t *mag);
+  bool readSample(fxos8700Sample_t *sample);
+
+  /*!
+      @brief  Reads a sample and adds it to a ring buffer.
+      @param  buffer The Adafruit_FXOS8700_SampleBuffer to fill.
+      @return True if a sample was read and stored, otherwise false.
+  */
+  template <uint16_t N>
+  bool readSample(Adafruit_FXOS8700_SampleBuffer<N> &buffer) {
+    fxos8700Sample_t sample;
+    return readSample(&sample) && buffer.push(sample);
+  }
+
+  void setTimestampSource(fxos8700TimestampSource_t source);
+  fxos8700TimestampSource_t getTimestampSource();
+  void setTimestampClock(uint32_t (*clock)(void));
+  void getIntervalStats(fxos8700IntervalStats_t *stats);
+  void resetIntervalStats();
+
+  void getStats(fxos8700Stats_t *stats);
+  void resetStats();
+
+  void setRetryPolicy(const fxos8700RetryPolicy_t &policy);
+  void getRetryPolicy(fxos8700RetryPolicy_t *policy);
+  fxos8700Status_t getLastError();
+  bool recover();
+
+  bool setAsyncTransport(const fxos8700AsyncTransport_t *transport);
+  bool startRead();
+  bool isReadComplete();
+  bool finishRead(sensors_event_t *accel, sensors_event_t *mag);
+
+  bool readAccelFixed(fxos8700FixedData_t *accel);
+  void convertAccelFixed(const fxos8700RawData_t *raw,
+                         fxos8700FixedData_t *out);
+  void convertAccel(const fxos8700RawData_t *raw, float *xyz, size_t n);
+  void convertMag(const fxos8700RawData_t *raw, float *xyz, size_t n);
+  bool standby(boolean standby);
+  fxos8700Status_t
+  requestStandby(boolean standby,
+                 uint32_t timeout_us = FXOS8700_STANDBY_TIMEOUT_US);
+  fxos8700Status_t pollStandby();
 
   /*! Raw accelerometer values from last sucsessful sensor read */
   fxos8700RawData_t accel_raw;
@@ -281,27 +1053,182 @@ public:
       NULL; ///< Accelerometer data object
   Adafruit_FXOS8700_Magnetometer *mag_sensor = NULL; ///< Mag data object
 
-  void setSensorMode(fxos8700SensorMode_t mode);
+  fxos8700Status_t setSensorMode(fxos8700SensorMode_t mode);
+  void setHybridEvent(fxos8700HybridEvent_t event);
+  fxos8700HybridEvent_t getHybridEvent();
   fxos8700SensorMode_t getSensorMode();
 
-  void setAccelRange(fxos8700AccelRange_t range);
+  fxos8700Status_t setAccelRange(fxos8700AccelRange_t range);
   fxos8700AccelRange_t getAccelRange();
 
-  void setOutputDataRate(fxos8700ODR_t rate);
+  void setAccelFixedFormat(fxos8700FixedFormat_t format);
+  fxos8700FixedFormat_t getAccelFixedFormat();
+
+  fxos8700Status_t setOutputDataRate(fxos8700ODR_t rate);
   fxos8700ODR_t getOutputDataRate();
+  float getOutputDataRateHz();
 
-  void setMagOversamplingRatio(fxos8700MagOSR_t ratio);
+  fxos8700Status_t setMagOversamplingRatio(fxos8700MagOSR_t ratio);
   fxos8700MagOSR_t getMagOversamplingRatio();
 
+  bool applyConfig(const fxos8700Config_t &config);
+  void getConfig(fxos8700Config_t *config);
+
+  bool enableAutoSleep(const fxos8700AutoSleepConfig_t &config);
+  fxos8700Status_t disableAutoSleep();
+  fxos8700SystemStatus_t getSystemMode(float *effectiveRateHz = NULL);
+
+  bool enableAdaptiveRate(const fxos8700AdaptiveConfig_t &config =
+                              FXOS8700_DEFAULT_ADAPTIVE_CONFIG);
+  fxos8700Status_t disableAdaptiveRate();
+
+  fxos8700Status_t
+  setHighPassFilter(bool enable,
+                    fxos8700HighPassCutoff_t cutoff = HPF_CUTOFF_16HZ);
+  bool getHighPassFilter();
+
+  bool setAccelOffsets(const fxos8700RawData_t *offsets);
+  bool getAccelOffsets(fxos8700RawData_t *offsets);
+  bool calibrateAccelOffsets(
+      fxos8700Axis_t up = AXIS_Z,
+      uint16_t samples = FXOS8700_ACCEL_CALIBRATION_SAMPLES,
+      fxos8700RawData_t *offsets = NULL);
+
+  bool setMagOffsets(const fxos8700RawData_t *offsets);
+  bool getMagOffsets(fxos8700RawData_t *offsets);
+  fxos8700Status_t enableMagAutoCalibration(bool enable);
+  bool getMagAutoCalibration();
+  fxos8700Status_t enableMagMinMax(bool enable);
+  fxos8700Status_t resetMagMinMax();
+  bool getMagMinMax(fxos8700RawData_t *minValues,
+                    fxos8700RawData_t *maxValues);
+
+  fxos8700Status_t setFifoMode(fxos8700FifoMode_t mode,
+                               uint8_t watermark = 0);
+  fxos8700FifoMode_t getFifoMode();
+  uint8_t getFifoCount();
+  size_t readFifo(fxos8700RawData_t *out, size_t maxSamples);
+
+  fxos8700Status_t
+  enableDataReadyInterrupt(bool enable,
+                           fxos8700InterruptPin_t intPin = INT_PIN_1);
+  bool attachDataReadyInterrupt(uint8_t pin, void (*callback)(void),
+                                fxos8700InterruptPin_t intPin = INT_PIN_1);
+  bool available();
+
+  fxos8700Status_t setTapDetection(const fxos8700TapConfig_t &config,
+                                   fxos8700InterruptPin_t intPin = INT_PIN_1);
+  fxos8700Status_t
+  setFreefallMotionDetection(const fxos8700FreefallMotionConfig_t &config,
+                             fxos8700InterruptPin_t intPin = INT_PIN_1);
+  fxos8700Status_t
+  setTransientDetection(const fxos8700TransientConfig_t &config,
+                        fxos8700InterruptPin_t intPin = INT_PIN_1);
+  fxos8700Status_t
+  setOrientationDetection(bool enable, uint8_t count = 0,
+                          fxos8700InterruptPin_t intPin = INT_PIN_1);
+  fxos8700Status_t
+  setMagThresholdDetection(const fxos8700MagThresholdConfig_t &config,
+                           fxos8700InterruptPin_t intPin = INT_PIN_1);
+  bool setMagVectorDetection(const fxos8700MagVectorConfig_t &config,
+                             const fxos8700RawData_t *reference = NULL,
+                             fxos8700InterruptPin_t intPin = INT_PIN_1);
+  bool getMagReferenceVector(fxos8700RawData_t *reference);
+  bool attachEventInterrupt(uint8_t pin, void (*callback)(void));
+  bool readEvents(fxos8700Events_t *events);
+
 protected:
   Adafruit_I2CDevice *i2c_dev = NULL; ///< Pointer to I2C bus interface
+  Adafruit_SPIDevice *spi_dev = NULL; ///< Pointer to SPI bus interface
+  Adafruit_FXOS8700_Transport *_transport =
+      NULL; ///< Register transport set by begin_Transport(), not owned
 
 private:
+  friend class Adafruit_FXOS8700_Accelerometer;
+  friend class Adafruit_FXOS8700_Magnetometer;
+
   bool initialize();
+  void updateAccelScale();
+  bool lookupOutputDataRate(fxos8700SensorMode_t mode, fxos8700ODR_t rate,
+                            uint8_t *odr);
+  uint8_t *shadowRegister(uint8_t reg);
+  bool readRegisters(uint8_t reg, uint8_t *buffer, size_t len);
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, size_t len);
+  bool readRegister(uint8_t reg, uint8_t *value);
+  bool writeRegister(uint8_t reg, uint8_t value);
+  bool writeBits(uint8_t reg, uint8_t bits, uint8_t shift, uint8_t value);
+  void recordTransfer(size_t written, size_t read, uint32_t elapsed, bool ok);
+  bool retryTransfer(uint8_t attempts, uint32_t first);
+  bool completeTransfer(bool ok);
+  void runPendingRecovery();
+  bool routeInterrupt(uint8_t source, bool enable,
+                      fxos8700InterruptPin_t intPin);
+  bool lookupSleepRate(fxos8700ODR_t rate, uint8_t *aslpRate);
+  bool writeAutoSleep(const fxos8700AutoSleepConfig_t &config,
+                      uint8_t aslpRate);
+  bool clearAutoSleep();
+  uint32_t timestamp();
+  void recordSampleInterval(uint32_t now);
+  bool readBurst(fxos8700RawData_t *accel, fxos8700RawData_t *mag,
+                 uint8_t *status);
+  void planBurst(bool *accel, bool *mag, uint8_t *reg, uint8_t *len);
+  void decodeBurst(const uint8_t *buffer, fxos8700RawData_t *accel,
+                   fxos8700RawData_t *mag);
+  bool updateRaw(bool accel, bool mag);
+  void fillEvents(sensors_event_t *accelEvent, sensors_event_t *magEvent,
+                  uint32_t timestamp);
+  bool hasEnabledEvent(const sensors_event_t *accelEvent,
+                       const sensors_event_t *magEvent);
+  bool getCachedEvent(sensors_event_t *accelEvent, sensors_event_t *magEvent);
   fxos8700SensorMode_t _mode = HYBRID_MODE;
+  fxos8700HybridEvent_t _hybridEvent = HYBRID_EVENT_ACCEL;
+  bool _hybridMagNext = false; ///< The next alternating event is the mag
   fxos8700AccelRange_t _range = ACCEL_RANGE_2G;
   fxos8700ODR_t _rate = ODR_100HZ;
   fxos8700MagOSR_t _ratio = MAG_OSR_7;
+  fxos8700FifoMode_t _fifoMode = FIFO_MODE_DISABLED;
+  fxos8700FixedFormat_t _fixedFormat = ACCEL_FIXED_MILLI_G;
+  float _accelScale;          ///< m/s^2 per LSB at the current range
+  int32_t _accelFixedScale;   ///< Fixed-point multiplier per LSB
+  uint8_t _accelFixedShift;   ///< Right shift applied after the multiply
+  uint8_t _ctrlReg[5] = {0};  ///< Shadow copy of CTRL_REG1..CTRL_REG5
+  uint8_t _xyzDataCfg = 0;    ///< Shadow copy of XYZ_DATA_CFG
+  uint8_t _fSetup = 0;        ///< Shadow copy of F_SETUP
+  uint8_t _mctrlReg[3] = {0}; ///< Shadow copy of MCTRL_REG1..MCTRL_REG3
+  fxos8700RetryPolicy_t _retryPolicy = FXOS8700_DEFAULT_RETRY_POLICY;
+  fxos8700Status_t _lastError = FXOS8700_OK;
+  uint8_t _consecutiveFailures = 0;
+  bool _recovering = false;
+  bool _recoverPending = false; ///< Set once recoverAfter is reached
+  uint8_t _sleepIntEnables = 0; ///< CTRL_REG4 bits set only for auto-sleep
+  bool _standbyPending = false;
+  bool _standbyTarget = false;
+  uint32_t _standbyStart = 0;
+  uint32_t _standbyTimeout = 0;
+  bool _sampleCached = false;
+  uint32_t _sampleMicros = 0;
+  uint32_t _sampleTime = 0;
+  const fxos8700AsyncTransport_t *_asyncTransport = NULL;
+  fxos8700Status_t _asyncStatus = FXOS8700_OK;
+  bool _asyncUnread = false;
+  uint8_t _asyncBuffer[13];
+  uint8_t _asyncReg = 0;
+  uint8_t _asyncLen = 0;
+  bool _asyncAccel = false;
+  bool _asyncMag = false;
+  uint32_t _asyncMicros = 0;
+  uint32_t _asyncTime = 0;
+  fxos8700TimestampSource_t _timestampSource = TIMESTAMP_MILLIS;
+  uint32_t (*_timestampClock)(void) = NULL;
+  bool _intervalStarted = false;
+  uint32_t _intervalLast = 0;
+  uint32_t _intervalCount = 0;
+  uint32_t _intervalMin = 0;
+  uint32_t _intervalMax = 0;
+  uint64_t _intervalTotal = 0;
+#if FXOS8700_ENABLE_STATS
+  fxos8700Stats_t _stats = {0, 0, 0, 0, 0, 0, 0, 0};
+#endif
   int32_t _accelSensorID;
   int32_t _magSensorID;
 };
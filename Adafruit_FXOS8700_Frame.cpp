@@ -0,0 +1,381 @@
+/*!
+ * @file Adafruit_FXOS8700_Frame.cpp
+ *
+ * Compact packed frame format for logging and transmitting FXOS8700
+ * samples, see Adafruit_FXOS8700_Frame.h for the layout.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#include "Adafruit_FXOS8700_Frame.h"
+
+/** Bits of one packed accelerometer axis */
+#define ACCEL_BITS (14)
+/** Bits of one packed magnetometer axis */
+#define MAG_BITS (16)
+
+/***************************************************************************
+ ENCODER PRIVATE FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Appends bits to the frame, most significant first.
+
+    @param  value The value, in its low bits.
+    @param  bits The number of bits to write.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_FrameEncoder::writeBits(uint32_t value, uint8_t bits) {
+  while (bits--) {
+    uint8_t &byte = _buffer[_bit >> 3];
+    uint8_t mask = 0x80 >> (_bit & 7);
+
+    /* The buffer isn't cleared up front, so start each byte empty */
+    if ((_bit & 7) == 0)
+      byte = 0;
+    if ((value >> bits) & 1)
+      byte |= mask;
+    _bit++;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Appends a timestamp delta, 7 bits per group least significant
+            first, with the top bit of a group set if another follows.
+
+    @param  delta The delta in microseconds.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_FrameEncoder::writeDelta(uint32_t delta) {
+  while (delta >= 0x80) {
+    writeBits(0x80 | (delta & 0x7F), 8);
+    delta >>= 7;
+  }
+  writeBits(delta, 8);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks a sample fits, then writes its overrun flag and
+            timestamp.
+
+    @param  timestamp The micros() of the sample.
+    @param  overrun Whether the sensor overwrote a sample before this one.
+
+    @return True if the sample fits in the frame, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_FrameEncoder::startSample(uint32_t timestamp,
+                                                 bool overrun) {
+  if (!_buffer || _count >= FXOS8700_FRAME_MAX_SAMPLES)
+    return false;
+
+  uint32_t delta = _count ? timestamp - _last : 0;
+  size_t bits =
+      1 + 8 + (_accel ? 3 * ACCEL_BITS : 0) + (_mag ? 3 * MAG_BITS : 0);
+  for (uint32_t rest = delta; rest >= 0x80; rest >>= 7)
+    bits += 8;
+  if (_bit + bits > _size * 8)
+    return false;
+
+  /* The first sample's timestamp is the frame's base */
+  if (_count == 0) {
+    for (uint8_t i = 0; i < 4; i++)
+      _buffer[3 + i] = timestamp >> (8 * i);
+  }
+
+  writeBits(overrun ? 1 : 0, 1);
+  writeDelta(delta);
+  _last = timestamp;
+  _count++;
+  return true;
+}
+
+/***************************************************************************
+ ENCODER PUBLIC FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Starts a new, empty frame.
+
+    @param  buffer The buffer to write the frame into.
+    @param  size The size of buffer in bytes.
+    @param  config The sensor configuration the samples are read with,
+                   from Adafruit_FXOS8700::getConfig().
+
+    @return True if the header fits in buffer, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_FrameEncoder::begin(uint8_t *buffer, size_t size,
+                                           const fxos8700Config_t &config) {
+  _buffer = NULL;
+  if (!buffer || size < FXOS8700_FRAME_HEADER_SIZE)
+    return false;
+
+  _buffer = buffer;
+  _size = size;
+  _bit = FXOS8700_FRAME_HEADER_SIZE * 8;
+  _count = 0;
+  _last = 0;
+  _accel = config.mode != MAG_ONLY_MODE;
+  _mag = config.mode != ACCEL_ONLY_MODE;
+
+  memset(_buffer, 0, FXOS8700_FRAME_HEADER_SIZE);
+  _buffer[0] = FXOS8700_FRAME_VERSION;
+  _buffer[1] = (config.mode << 6) | (config.range << 4) | (config.rate & 0x0F);
+
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a sample from Adafruit_FXOS8700::readSample().
+
+    @param  sample The sample to add.
+
+    @return True if the sample was added, false if the frame is full.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_FrameEncoder::add(const fxos8700Sample_t &sample) {
+  if (!startSample(sample.timestamp, sample.status & 0x80))
+    return false;
+
+  if (_accel) {
+    writeBits(sample.accel.x, ACCEL_BITS);
+    writeBits(sample.accel.y, ACCEL_BITS);
+    writeBits(sample.accel.z, ACCEL_BITS);
+  }
+  if (_mag) {
+    writeBits((uint16_t)sample.mag.x, MAG_BITS);
+    writeBits((uint16_t)sample.mag.y, MAG_BITS);
+    writeBits((uint16_t)sample.mag.z, MAG_BITS);
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a sample straight from a burst read, without decoding it
+            first.
+
+    @param  burst The bytes read from STATUS (M_DR_STATUS in mag-only
+                  mode), 13 in hybrid mode, otherwise 7.
+    @param  timestamp The micros() the burst was read at.
+
+    @return True if the sample was added, false if the frame is full.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_FrameEncoder::addBurst(const uint8_t *burst,
+                                              uint32_t timestamp) {
+  if (!startSample(timestamp, burst[0] & 0x80))
+    return false;
+
+  const uint8_t *data = burst + 1;
+  if (_accel) {
+    /* The accel counts are left-aligned, drop the two unused bits */
+    for (uint8_t i = 0; i < 3; i++, data += 2)
+      writeBits(((data[0] << 8) | data[1]) >> 2, ACCEL_BITS);
+  }
+  if (_mag) {
+    for (uint8_t i = 0; i < 3; i++, data += 2)
+      writeBits((data[0] << 8) | data[1], MAG_BITS);
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of samples added since begin().
+
+    @return The sample count.
+*/
+/**************************************************************************/
+uint8_t Adafruit_FXOS8700_FrameEncoder::getCount() { return _count; }
+
+/**************************************************************************/
+/*!
+    @brief  Completes the frame header. More samples can still be added
+            afterwards, as long as finish() is called again.
+
+    @return The frame length in bytes, 0 if begin() failed.
+*/
+/**************************************************************************/
+size_t Adafruit_FXOS8700_FrameEncoder::finish() {
+  if (!_buffer)
+    return 0;
+
+  _buffer[2] = _count;
+  return (_bit + 7) / 8;
+}
+
+/***************************************************************************
+ DECODER PRIVATE FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Reads bits from the frame, most significant first.
+
+    @param  bits The number of bits to read, at most 32.
+    @param  value Set to the bits read.
+
+    @return True if the bits were inside the frame, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_FrameDecoder::readBits(uint8_t bits, uint32_t *value) {
+  if (_bit + bits > _size * 8)
+    return false;
+
+  *value = 0;
+  while (bits--) {
+    *value = (*value << 1) | ((_buffer[_bit >> 3] >> (7 - (_bit & 7))) & 1);
+    _bit++;
+  }
+  return true;
+}
+
+/***************************************************************************
+ DECODER PUBLIC FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Starts decoding a frame.
+
+    @param  buffer The frame.
+    @param  size The number of bytes in buffer.
+
+    @return True if buffer holds a frame of this version, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_FrameDecoder::begin(const uint8_t *buffer,
+                                           size_t size) {
+  _buffer = NULL;
+  _count = 0;
+  if (!buffer || size < FXOS8700_FRAME_HEADER_SIZE ||
+      buffer[0] != FXOS8700_FRAME_VERSION)
+    return false;
+
+  /* m_hms = 0b10 is reserved */
+  if ((buffer[1] >> 6) == 0b10)
+    return false;
+
+  _buffer = buffer;
+  _size = size;
+  _bit = FXOS8700_FRAME_HEADER_SIZE * 8;
+  _index = 0;
+  _count = buffer[2];
+  _config = buffer[1];
+  _last = 0;
+  for (uint8_t i = 0; i < 4; i++)
+    _last |= (uint32_t)buffer[3 + i] << (8 * i);
+
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the sensor mode the frame was recorded in.
+
+    @return The fxos8700SensorMode_t from the header.
+*/
+/**************************************************************************/
+fxos8700SensorMode_t Adafruit_FXOS8700_FrameDecoder::getSensorMode() {
+  return (fxos8700SensorMode_t)(_config >> 6);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the accelerometer range the frame was recorded with, which
+            sets the scale of the accelerometer counts.
+
+    @return The fxos8700AccelRange_t from the header.
+*/
+/**************************************************************************/
+fxos8700AccelRange_t Adafruit_FXOS8700_FrameDecoder::getAccelRange() {
+  return (fxos8700AccelRange_t)((_config >> 4) & 0x03);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the output data rate the frame was recorded at.
+
+    @return The fxos8700ODR_t from the header.
+*/
+/**************************************************************************/
+fxos8700ODR_t Adafruit_FXOS8700_FrameDecoder::getOutputDataRate() {
+  return (fxos8700ODR_t)(_config & 0x0F);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of samples in the frame.
+
+    @return The sample count from the header.
+*/
+/**************************************************************************/
+uint8_t Adafruit_FXOS8700_FrameDecoder::getCount() { return _count; }
+
+/**************************************************************************/
+/*!
+    @brief  Decodes the next sample.
+
+    @param  sample The fxos8700Sample_t to fill in. Counts for a sensor
+                   that isn't in the frame are zero, and status only has
+                   bit 7 (zyxow) kept.
+
+    @return True if a sample was decoded, false at the end of the frame or
+            if the frame is truncated.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_FrameDecoder::next(fxos8700Sample_t *sample) {
+  if (!_buffer || _index >= _count)
+    return false;
+
+  uint32_t overrun, group, delta = 0;
+  if (!readBits(1, &overrun))
+    return false;
+  for (uint8_t shift = 0;; shift += 7) {
+    if (shift > 28 || !readBits(8, &group))
+      return false;
+    delta |= (group & 0x7F) << shift;
+    if (!(group & 0x80))
+      break;
+  }
+
+  *sample = fxos8700Sample_t();
+  int16_t *const accel[3] = {&sample->accel.x, &sample->accel.y,
+                             &sample->accel.z};
+  int16_t *const mag[3] = {&sample->mag.x, &sample->mag.y, &sample->mag.z};
+  fxos8700SensorMode_t mode = getSensorMode();
+  uint32_t value;
+
+  if (mode != MAG_ONLY_MODE) {
+    for (uint8_t i = 0; i < 3; i++) {
+      if (!readBits(ACCEL_BITS, &value))
+        return false;
+      /* Sign extend the 14-bit counts */
+      *accel[i] = (int16_t)(value << 2) >> 2;
+    }
+  }
+  if (mode != ACCEL_ONLY_MODE) {
+    for (uint8_t i = 0; i < 3; i++) {
+      if (!readBits(MAG_BITS, &value))
+        return false;
+      *mag[i] = (int16_t)value;
+    }
+  }
+
+  _last += delta;
+  sample->timestamp = _last;
+  sample->status = overrun ? 0x80 : 0x00;
+  _index++;
+  return true;
+}
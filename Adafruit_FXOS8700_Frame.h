@@ -0,0 +1,109 @@
+/*!
+ * @file Adafruit_FXOS8700_Frame.h
+ *
+ * Compact packed frame format for logging and transmitting FXOS8700
+ * samples.
+ *
+ * A frame is a 7 byte header followed by a bitstream of samples, written
+ * most significant bit first and zero padded to a whole byte:
+ *
+ *   byte 0     FXOS8700_FRAME_VERSION
+ *   byte 1     m_hms[1:0] << 6 | fs[1:0] << 4 | fxos8700ODR_t
+ *   byte 2     Number of samples
+ *   bytes 3-6  micros() of the first sample, little-endian
+ *
+ * Each sample is, with the sensors that are enabled in the header's mode:
+ *
+ *   1 bit      The sensor overwrote a sample before this one was read
+ *   8n bits    Microseconds since the previous sample, 7 bits per group
+ *              least significant first, the top bit of a group set if
+ *              another follows. 0 for the first sample
+ *   3 x 14     Accelerometer counts, x, y, z (not in mag-only mode)
+ *   3 x 16     Magnetometer counts, x, y, z (not in accel-only mode)
+ *
+ * A hybrid sample at 100Hz takes 107 bits, against 72 bytes for a pair of
+ * sensors_event_t.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __FXOS8700_FRAME_H__
+#define __FXOS8700_FRAME_H__
+
+#include "Adafruit_FXOS8700.h"
+
+/** Format version in the first byte of every frame */
+#define FXOS8700_FRAME_VERSION (0x01)
+/** Length of the frame header in bytes */
+#define FXOS8700_FRAME_HEADER_SIZE (7)
+/** Most samples a frame can hold */
+#define FXOS8700_FRAME_MAX_SAMPLES (255)
+
+/**************************************************************************/
+/*!
+    @brief  Packs samples into a frame in a caller supplied buffer.
+
+            Samples can be added either decoded, from readSample(), or as
+            the burst buffer the sensor returned (e.g. through an
+            fxos8700AsyncTransport_t), in which case the counts are packed
+            straight from the register bytes.
+*/
+/**************************************************************************/
+class Adafruit_FXOS8700_FrameEncoder {
+public:
+  bool begin(uint8_t *buffer, size_t size, const fxos8700Config_t &config);
+
+  bool add(const fxos8700Sample_t &sample);
+  bool addBurst(const uint8_t *burst, uint32_t timestamp);
+
+  uint8_t getCount();
+  size_t finish();
+
+private:
+  bool startSample(uint32_t timestamp, bool overrun);
+  void writeBits(uint32_t value, uint8_t bits);
+  void writeDelta(uint32_t delta);
+
+  uint8_t *_buffer = NULL;
+  size_t _size = 0;
+  size_t _bit = 0; ///< Next bit to write, counted from the frame start
+  uint8_t _count = 0;
+  bool _accel = false; ///< The frame's mode includes the accelerometer
+  bool _mag = false;   ///< The frame's mode includes the magnetometer
+  uint32_t _last = 0;  ///< Timestamp of the previous sample
+};
+
+/**************************************************************************/
+/*!
+    @brief  Unpacks the samples of a frame written by
+            Adafruit_FXOS8700_FrameEncoder.
+*/
+/**************************************************************************/
+class Adafruit_FXOS8700_FrameDecoder {
+public:
+  bool begin(const uint8_t *buffer, size_t size);
+
+  fxos8700SensorMode_t getSensorMode();
+  fxos8700AccelRange_t getAccelRange();
+  fxos8700ODR_t getOutputDataRate();
+  uint8_t getCount();
+
+  bool next(fxos8700Sample_t *sample);
+
+private:
+  bool readBits(uint8_t bits, uint32_t *value);
+
+  const uint8_t *_buffer = NULL;
+  size_t _size = 0;
+  size_t _bit = 0; ///< Next bit to read, counted from the frame start
+  uint8_t _index = 0;
+  uint8_t _count = 0;
+  uint8_t _config = 0; ///< Header byte 1
+  uint32_t _last = 0;  ///< Timestamp of the previous sample
+};
+
+#endif
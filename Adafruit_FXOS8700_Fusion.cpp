@@ -0,0 +1,447 @@
+/*!
+ * @file Adafruit_FXOS8700_Fusion.cpp
+ *
+ * Orientation filter working directly on the raw FXOS8700 samples.
+ *
+ * The filter is written once against the small set of arithmetic helpers
+ * below, which are either plain float operations or Q2.30 fixed-point
+ * ones depending on FXOS8700_FUSION_FIXED.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#include "Adafruit_FXOS8700_Fusion.h"
+
+#include <math.h>
+
+typedef fxos8700FusionReal_t real_t;
+
+/** 0.5 in quaternion units */
+#define HALF (FXOS8700_FUSION_UNIT / 2)
+
+/***************************************************************************
+ ARITHMETIC HELPERS
+ ***************************************************************************/
+
+#if FXOS8700_FUSION_FIXED
+
+/* Integer square root of a 64-bit value */
+static uint32_t isqrt(uint64_t value) {
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+
+  while (bit > value)
+    bit >>= 2;
+  while (bit) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+/* Product of two unit values */
+static inline real_t mul(real_t a, real_t b) {
+  return ((int64_t)a * b) >> 30;
+}
+
+/* Quotient in unit values, |a| must not exceed |b| by more than 2x */
+static inline real_t divide(real_t a, real_t b) {
+  return ((int64_t)a << 30) / b;
+}
+
+/* Square root of a non-negative unit value */
+static inline real_t root(real_t a) {
+  return (a > 0) ? isqrt((uint64_t)a << 30) : 0;
+}
+
+/* Length of the 2D vector (a, b) */
+static inline real_t norm2(real_t a, real_t b) {
+  return isqrt((int64_t)a * a + (int64_t)b * b);
+}
+
+/* A gyro rate in Q16.16 rad/s times half_dt, as a unit value */
+static inline real_t rateStep(real_t rate, real_t half_dt) {
+  return ((int64_t)rate * half_dt) >> 16;
+}
+
+/* A float converted to a unit value once at setup, clamped to +/-1.99 */
+static real_t toUnit(float value) {
+  if (value > 1.99F)
+    value = 1.99F;
+  if (value < -1.99F)
+    value = -1.99F;
+  return value * FXOS8700_FUSION_UNIT + ((value < 0) ? -0.5F : 0.5F);
+}
+
+/* atan2(y, x) in Q16.16 degrees. The rational approximation of atan() is
+   within 0.1 degree over the whole circle */
+static real_t degrees(real_t y, real_t x) {
+  int64_t ay = (y < 0) ? -(int64_t)y : y;
+  int64_t ax = (x < 0) ? -(int64_t)x : x;
+  if (ax == 0 && ay == 0)
+    return 0;
+
+  /* Reduce to the first octant, r = tan(angle) in Q16 */
+  bool swap = ay > ax;
+  int64_t r = swap ? (ax << 16) / ay : (ay << 16) / ax;
+
+  /* 45r + r(1 - r)(14.0203 + 3.7987r) */
+  int64_t angle = 45 * r + (((r * (65536 - r)) >> 16) *
+                            (918834 + ((248951 * r) >> 16)) >>
+                            16);
+
+  if (swap)
+    angle = 90 * FXOS8700_FUSION_SCALE - angle;
+  if (x < 0)
+    angle = 180 * FXOS8700_FUSION_SCALE - angle;
+  if (y < 0)
+    angle = -angle;
+  return angle;
+}
+
+#else
+
+static inline real_t mul(real_t a, real_t b) { return a * b; }
+
+static inline real_t divide(real_t a, real_t b) { return a / b; }
+
+static inline real_t root(real_t a) { return (a > 0) ? sqrtf(a) : 0; }
+
+static inline real_t norm2(real_t a, real_t b) { return sqrtf(a * a + b * b); }
+
+static inline real_t rateStep(real_t rate, real_t half_dt) {
+  return rate * half_dt;
+}
+
+static inline real_t toUnit(float value) { return value; }
+
+static inline real_t degrees(real_t y, real_t x) {
+  return atan2f(y, x) * 57.2957795F;
+}
+
+#endif
+
+/* Scales a vector to unit length, false if it has no direction */
+static bool normalize(real_t *v, uint8_t n) {
+#if FXOS8700_FUSION_FIXED
+  uint64_t sum = 0;
+  for (uint8_t i = 0; i < n; i++)
+    sum += (int64_t)v[i] * v[i];
+  real_t norm = isqrt(sum);
+#else
+  float sum = 0;
+  for (uint8_t i = 0; i < n; i++)
+    sum += v[i] * v[i];
+  real_t norm = sqrtf(sum);
+#endif
+
+  if (norm == 0)
+    return false;
+  for (uint8_t i = 0; i < n; i++)
+    v[i] = divide(v[i], norm);
+  return true;
+}
+
+/* out = a x b, for unit vectors */
+static void cross(const real_t *a, const real_t *b, real_t *out) {
+  out[0] = mul(a[1], b[2]) - mul(a[2], b[1]);
+  out[1] = mul(a[2], b[0]) - mul(a[0], b[2]);
+  out[2] = mul(a[0], b[1]) - mul(a[1], b[0]);
+}
+
+/* Roll and pitch from the up vector, heading from the x axis components
+   of north and west, all in body coordinates */
+static void fillOrientation(const real_t *up, real_t north_x, real_t west_x,
+                            fxos8700Orientation_t *orientation) {
+  orientation->roll = degrees(up[1], up[2]);
+  orientation->pitch = degrees(-up[0], norm2(up[1], up[2]));
+  orientation->heading = degrees(-west_x, north_x);
+  if (orientation->heading < 0)
+    orientation->heading += 360 * FXOS8700_FUSION_SCALE;
+}
+
+/* Unit up, west and north vectors in body coordinates from a reading */
+static bool earthAxes(const fxos8700RawData_t &accel,
+                      const fxos8700RawData_t &mag, real_t *up, real_t *west,
+                      real_t *north) {
+  real_t m[3] = {(real_t)mag.x, (real_t)mag.y, (real_t)mag.z};
+  up[0] = accel.x;
+  up[1] = accel.y;
+  up[2] = accel.z;
+  if (!normalize(up, 3) || !normalize(m, 3))
+    return false;
+
+  cross(up, m, west);
+  if (!normalize(west, 3))
+    return false;
+  cross(west, up, north);
+  return true;
+}
+
+/***************************************************************************
+ CONSTRUCTOR
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates a new Adafruit_FXOS8700_Fusion class. Call begin()
+            with the sample rate before the first update().
+*/
+/**************************************************************************/
+Adafruit_FXOS8700_Fusion::Adafruit_FXOS8700_Fusion() { reset(); }
+
+/***************************************************************************
+ PRIVATE FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Sets the quaternion from the earth axes in body coordinates,
+            the rows of the body to earth rotation matrix.
+
+    @param  up The up axis.
+    @param  west The west axis.
+    @param  north The north axis.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Fusion::seed(const real_t *up, const real_t *west,
+                                    const real_t *north) {
+  /* Shepperd's method, with every term quartered to stay within the range
+     of the fixed-point unit values */
+  real_t trace = north[0] / 4 + west[1] / 4 + up[2] / 4;
+
+  if (trace > 0) {
+    _q[0] = root(FXOS8700_FUSION_UNIT / 4 + trace);
+    _q[1] = divide(up[1] / 4 - west[2] / 4, _q[0]);
+    _q[2] = divide(north[2] / 4 - up[0] / 4, _q[0]);
+    _q[3] = divide(west[0] / 4 - north[1] / 4, _q[0]);
+  } else if (north[0] > west[1] && north[0] > up[2]) {
+    _q[1] = root(FXOS8700_FUSION_UNIT / 4 + north[0] / 4 - west[1] / 4 -
+                 up[2] / 4);
+    _q[0] = divide(up[1] / 4 - west[2] / 4, _q[1]);
+    _q[2] = divide(north[1] / 4 + west[0] / 4, _q[1]);
+    _q[3] = divide(north[2] / 4 + up[0] / 4, _q[1]);
+  } else if (west[1] > up[2]) {
+    _q[2] = root(FXOS8700_FUSION_UNIT / 4 + west[1] / 4 - north[0] / 4 -
+                 up[2] / 4);
+    _q[0] = divide(north[2] / 4 - up[0] / 4, _q[2]);
+    _q[1] = divide(north[1] / 4 + west[0] / 4, _q[2]);
+    _q[3] = divide(west[2] / 4 + up[1] / 4, _q[2]);
+  } else {
+    _q[3] = root(FXOS8700_FUSION_UNIT / 4 + up[2] / 4 - north[0] / 4 -
+                 west[1] / 4);
+    _q[0] = divide(west[0] / 4 - north[1] / 4, _q[3]);
+    _q[1] = divide(north[2] / 4 + up[0] / 4, _q[3]);
+    _q[2] = divide(west[2] / 4 + up[1] / 4, _q[3]);
+  }
+
+  normalize(_q, 4);
+  _seeded = true;
+}
+
+/***************************************************************************
+ PUBLIC FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Sets the sample rate and filter gains. The gains are converted
+            once here, so update() does no floating point in fixed-point
+            builds.
+
+    @param  sampleRateHz The rate update() is called at, normally
+                         Adafruit_FXOS8700::getOutputDataRateHz().
+    @param  kp The proportional gain in 1/s.
+    @param  ki The integral gain in 1/s^2.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Fusion::begin(float sampleRateHz, float kp, float ki) {
+  float dt = (sampleRateHz > 0) ? 1.0F / sampleRateHz : 0;
+
+  _pGain = toUnit(kp * dt);
+  _iGain = toUnit(ki * dt * dt);
+  _halfDt = toUnit(dt / 2);
+  reset();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Discards the orientation estimate. The next update() starts
+            again from the eCompass reading.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Fusion::reset() {
+  _q[0] = FXOS8700_FUSION_UNIT;
+  _q[1] = _q[2] = _q[3] = 0;
+  _integral[0] = _integral[1] = _integral[2] = 0;
+  _seeded = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Runs one filter step.
+
+    @param  accel The raw accelerometer counts.
+    @param  mag The raw, hard-iron corrected magnetometer counts.
+    @param  gyro The angular rates around x, y and z in rad/s scaled by
+                 FXOS8700_FUSION_SCALE, or NULL if there is no gyro.
+
+    @return True if the estimate was updated, false if either reading had
+            no direction (all zero, or accel and mag parallel).
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Fusion::update(const fxos8700RawData_t &accel,
+                                      const fxos8700RawData_t &mag,
+                                      const real_t *gyro) {
+  if (!_seeded) {
+    real_t up[3], west[3], north[3];
+    if (!earthAxes(accel, mag, up, west, north))
+      return false;
+    seed(up, west, north);
+    return true;
+  }
+
+  real_t a[3] = {(real_t)accel.x, (real_t)accel.y, (real_t)accel.z};
+  real_t m[3] = {(real_t)mag.x, (real_t)mag.y, (real_t)mag.z};
+  if (!normalize(a, 3) || !normalize(m, 3))
+    return false;
+
+  real_t q0 = _q[0], q1 = _q[1], q2 = _q[2], q3 = _q[3];
+  real_t q0q0 = mul(q0, q0), q0q1 = mul(q0, q1), q0q2 = mul(q0, q2);
+  real_t q0q3 = mul(q0, q3), q1q1 = mul(q1, q1), q1q2 = mul(q1, q2);
+  real_t q1q3 = mul(q1, q3), q2q2 = mul(q2, q2), q2q3 = mul(q2, q3);
+  real_t q3q3 = mul(q3, q3);
+
+  /* Field in the earth frame, rotated to have no west component */
+  real_t hx = 2 * (mul(m[0], HALF - q2q2 - q3q3) + mul(m[1], q1q2 - q0q3) +
+                   mul(m[2], q1q3 + q0q2));
+  real_t hy = 2 * (mul(m[0], q1q2 + q0q3) + mul(m[1], HALF - q1q1 - q3q3) +
+                   mul(m[2], q2q3 - q0q1));
+  real_t bx = norm2(hx, hy);
+  real_t bz = 2 * (mul(m[0], q1q3 - q0q2) + mul(m[1], q2q3 + q0q1) +
+                   mul(m[2], HALF - q1q1 - q2q2));
+
+  /* Half the up and field directions the estimate predicts */
+  real_t v[3] = {q1q3 - q0q2, q0q1 + q2q3, q0q0 - HALF + q3q3};
+  real_t w[3] = {mul(bx, HALF - q2q2 - q3q3) + mul(bz, q1q3 - q0q2),
+                 mul(bx, q1q2 - q0q3) + mul(bz, q0q1 + q2q3),
+                 mul(bx, q0q2 + q1q3) + mul(bz, HALF - q1q1 - q2q2)};
+
+  /* The error is the rotation taking the prediction onto the reading */
+  real_t ea[3], em[3], step[3];
+  cross(a, v, ea);
+  cross(m, w, em);
+  for (uint8_t i = 0; i < 3; i++) {
+    real_t error = ea[i] + em[i];
+    _integral[i] += mul(_iGain, error);
+    step[i] = mul(_pGain, error) + _integral[i];
+    if (gyro)
+      step[i] += rateStep(gyro[i], _halfDt);
+  }
+
+  /* q += q * (0, step), step already holds omega * dt / 2 */
+  _q[0] += -mul(q1, step[0]) - mul(q2, step[1]) - mul(q3, step[2]);
+  _q[1] += mul(q0, step[0]) + mul(q2, step[2]) - mul(q3, step[1]);
+  _q[2] += mul(q0, step[1]) - mul(q1, step[2]) + mul(q3, step[0]);
+  _q[3] += mul(q0, step[2]) + mul(q1, step[1]) - mul(q2, step[0]);
+  normalize(_q, 4);
+
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Runs one filter step on a sample from
+            Adafruit_FXOS8700::readSample(), which has to be read in hybrid
+            mode.
+
+    @param  sample The sample to filter.
+
+    @return True if the estimate was updated, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Fusion::update(const fxos8700Sample_t &sample) {
+  return update(sample.accel, sample.mag);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the orientation estimate as a quaternion.
+
+    @param  quaternion The fxos8700Quaternion_t to fill in.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Fusion::getQuaternion(fxos8700Quaternion_t *quaternion) {
+  quaternion->w = _q[0];
+  quaternion->x = _q[1];
+  quaternion->y = _q[2];
+  quaternion->z = _q[3];
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the orientation estimate as roll, pitch and heading.
+
+    @param  orientation The fxos8700Orientation_t to fill in.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Fusion::getOrientation(
+    fxos8700Orientation_t *orientation) {
+  real_t q0 = _q[0], q1 = _q[1], q2 = _q[2], q3 = _q[3];
+
+  /* The up axis, and the north and west components of the x axis */
+  real_t up[3] = {2 * (mul(q1, q3) - mul(q0, q2)),
+                  2 * (mul(q2, q3) + mul(q0, q1)),
+                  2 * (HALF - mul(q1, q1) - mul(q2, q2))};
+  real_t north_x = 2 * (HALF - mul(q2, q2) - mul(q3, q3));
+  real_t west_x = 2 * (mul(q1, q2) + mul(q0, q3));
+
+  fillOrientation(up, north_x, west_x, orientation);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the heading of the orientation estimate.
+
+    @return The magnetic heading of the x axis in degrees, clockwise from
+            north, scaled by FXOS8700_FUSION_SCALE.
+*/
+/**************************************************************************/
+real_t Adafruit_FXOS8700_Fusion::getHeading() {
+  fxos8700Orientation_t orientation;
+  getOrientation(&orientation);
+  return orientation.heading;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Tilt-compensated eCompass, the orientation of a single reading
+            without any filtering.
+
+    @param  accel The raw accelerometer counts.
+    @param  mag The raw, hard-iron corrected magnetometer counts.
+    @param  orientation The fxos8700Orientation_t to fill in.
+
+    @return True if the orientation was computed, false if either reading
+            had no direction.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Fusion::compass(const fxos8700RawData_t &accel,
+                                       const fxos8700RawData_t &mag,
+                                       fxos8700Orientation_t *orientation) {
+  real_t up[3], west[3], north[3];
+  if (!earthAxes(accel, mag, up, west, north))
+    return false;
+
+  fillOrientation(up, north[0], west[0], orientation);
+  return true;
+}
@@ -0,0 +1,121 @@
+/*!
+ * @file Adafruit_FXOS8700_Fusion.h
+ *
+ * Orientation filter working directly on the raw FXOS8700 samples.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __FXOS8700_FUSION_H__
+#define __FXOS8700_FUSION_H__
+
+#include "Adafruit_FXOS8700.h"
+
+#ifndef FXOS8700_FUSION_FIXED
+/** Set to 1 to build the filter in integer fixed-point instead of float,
+ * for targets without an FPU */
+#define FXOS8700_FUSION_FIXED (0)
+#endif
+
+#if FXOS8700_FUSION_FIXED
+/** Number type of the filter state and outputs */
+typedef int32_t fxos8700FusionReal_t;
+/** 1.0 for quaternion components, Q2.30 */
+#define FXOS8700_FUSION_UNIT ((int32_t)1 << 30)
+/** 1.0 for angles in degrees and rates in rad/s, Q16.16 */
+#define FXOS8700_FUSION_SCALE ((int32_t)1 << 16)
+#else
+/** Number type of the filter state and outputs */
+typedef float fxos8700FusionReal_t;
+/** 1.0 for quaternion components */
+#define FXOS8700_FUSION_UNIT (1.0F)
+/** 1.0 for angles in degrees and rates in rad/s */
+#define FXOS8700_FUSION_SCALE (1.0F)
+#endif
+
+/** Default proportional gain, the rate in 1/s at which the accelerometer
+ * and magnetometer pull the estimate towards their reading */
+#define FXOS8700_FUSION_KP (1.0F)
+/** Default integral gain, only useful to cancel gyro bias */
+#define FXOS8700_FUSION_KI (0.0F)
+
+/*!
+    @brief  Orientation as a unit quaternion, rotating body coordinates to
+            the north-west-up earth frame. Components are scaled by
+            FXOS8700_FUSION_UNIT
+*/
+typedef struct {
+  fxos8700FusionReal_t w; /**< Scalar part */
+  fxos8700FusionReal_t x; /**< X component */
+  fxos8700FusionReal_t y; /**< Y component */
+  fxos8700FusionReal_t z; /**< Z component */
+} fxos8700Quaternion_t;
+
+/*!
+    @brief  Orientation as angles in degrees, scaled by
+            FXOS8700_FUSION_SCALE
+*/
+typedef struct {
+  fxos8700FusionReal_t roll;    /**< Rotation about X, -180..180 */
+  fxos8700FusionReal_t pitch;   /**< Rotation about Y, -90..90 */
+  fxos8700FusionReal_t heading; /**< Magnetic heading of the X axis,
+                                     clockwise from north, 0..360 */
+} fxos8700Orientation_t;
+
+/**************************************************************************/
+/*!
+    @brief  Mahony orientation filter fed with raw FXOS8700 counts.
+
+            Only the direction of the accelerometer and magnetometer
+            vectors is used, so the raw counts go in without any unit
+            conversion or range scaling, and the filter state is a fixed
+            size member with no heap allocation. Hard-iron correction is
+            left to the chip, see Adafruit_FXOS8700::setMagOffsets().
+
+            The FXOS8700 has no gyro, so without one the filter low-pass
+            filters the eCompass orientation. At the default kp that takes
+            a second or two for tilt, and longer for heading where the
+            field is steep. A gyro such as the FXAS21002 on the same
+            breakout can be passed to update() to track fast motion.
+
+            Set FXOS8700_FUSION_FIXED to 1 before including this header to
+            build the filter without floating point in the per-sample path.
+*/
+/**************************************************************************/
+class Adafruit_FXOS8700_Fusion {
+public:
+  Adafruit_FXOS8700_Fusion();
+
+  void begin(float sampleRateHz, float kp = FXOS8700_FUSION_KP,
+             float ki = FXOS8700_FUSION_KI);
+  void reset();
+
+  bool update(const fxos8700RawData_t &accel, const fxos8700RawData_t &mag,
+              const fxos8700FusionReal_t *gyro = NULL);
+  bool update(const fxos8700Sample_t &sample);
+
+  void getQuaternion(fxos8700Quaternion_t *quaternion);
+  void getOrientation(fxos8700Orientation_t *orientation);
+  fxos8700FusionReal_t getHeading();
+
+  static bool compass(const fxos8700RawData_t &accel,
+                      const fxos8700RawData_t &mag,
+                      fxos8700Orientation_t *orientation);
+
+private:
+  void seed(const fxos8700FusionReal_t *up, const fxos8700FusionReal_t *west,
+            const fxos8700FusionReal_t *north);
+
+  fxos8700FusionReal_t _q[4];        ///< Quaternion w, x, y, z
+  fxos8700FusionReal_t _integral[3]; ///< Integral feedback, per step
+  fxos8700FusionReal_t _pGain = 0;   ///< kp * dt
+  fxos8700FusionReal_t _iGain = 0;   ///< ki * dt^2
+  fxos8700FusionReal_t _halfDt = 0;  ///< dt / 2, for the gyro rates
+  bool _seeded = false; ///< Set once the first update set the quaternion
+};
+
+#endif
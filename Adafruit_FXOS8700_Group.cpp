@@ -0,0 +1,231 @@
+/*!
+ * @file Adafruit_FXOS8700_Group.cpp
+ *
+ * Read scheduler for several FXOS8700 sensors sharing one or more buses.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#include "Adafruit_FXOS8700_Group.h"
+
+/***************************************************************************
+ CONSTRUCTOR
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates an empty Adafruit_FXOS8700_Group.
+*/
+/**************************************************************************/
+Adafruit_FXOS8700_Group::Adafruit_FXOS8700_Group() {
+  memset(_sensors, 0, sizeof(_sensors));
+}
+
+/***************************************************************************
+ PRIVATE FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Linearly interpolates one axis.
+
+    @param  from The value at the start of the span.
+    @param  to The value at the end of the span.
+    @param  offset The time into the span.
+    @param  span The length of the span, greater than offset.
+
+    @return The interpolated value.
+*/
+/**************************************************************************/
+static int16_t interpolate(int16_t from, int16_t to, int32_t offset,
+                           int32_t span) {
+  return from + (int32_t)(((int64_t)(to - from) * offset) / span);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Interpolates a sensor's last two reads to a point in time.
+
+    @param  index The sensor to align.
+    @param  timestamp The micros() time to align to.
+    @param  out The fxos8700Sample_t to fill in.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Group::alignSample(uint8_t index, uint32_t timestamp,
+                                          fxos8700Sample_t *out) {
+  const fxos8700Sample_t &prev = _previous[index];
+  const fxos8700Sample_t &cur = _current[index];
+
+  *out = cur;
+  out->timestamp = timestamp;
+
+  /* The first read has nothing to interpolate from */
+  if (!(_primed & (1 << index)))
+    return;
+
+  int32_t span = cur.timestamp - prev.timestamp;
+  int32_t offset = timestamp - prev.timestamp;
+  if (span <= 0 || offset < 0 || offset >= span)
+    return;
+
+  out->accel.x = interpolate(prev.accel.x, cur.accel.x, offset, span);
+  out->accel.y = interpolate(prev.accel.y, cur.accel.y, offset, span);
+  out->accel.z = interpolate(prev.accel.z, cur.accel.z, offset, span);
+  out->mag.x = interpolate(prev.mag.x, cur.mag.x, offset, span);
+  out->mag.y = interpolate(prev.mag.y, cur.mag.y, offset, span);
+  out->mag.z = interpolate(prev.mag.z, cur.mag.z, offset, span);
+}
+
+/***************************************************************************
+ PUBLIC FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Adds a sensor to the group. Call begin() afterwards to restart
+            the schedule.
+
+    @param  sensor The initialized sensor to add.
+
+    @return True if the sensor was added, false if the group is full.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Group::add(Adafruit_FXOS8700 *sensor) {
+  if (!sensor || _count >= FXOS8700_GROUP_MAX_SENSORS)
+    return false;
+
+  _sensors[_count++] = sensor;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the number of sensors in the group.
+
+    @return The sensor count.
+*/
+/**************************************************************************/
+uint8_t Adafruit_FXOS8700_Group::getCount() { return _count; }
+
+/**************************************************************************/
+/*!
+    @brief  Sets the frame period. Takes effect from the next begin().
+
+    @param  period_us The frame period in microseconds, or 0 to use the
+                      sample period of the slowest sensor, worked out again
+                      by every begin().
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Group::setPeriod(uint32_t period_us) {
+  _period = period_us;
+  _autoPeriod = (period_us == 0);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the frame period in use.
+
+    @return The frame period in microseconds, either the one set with
+            setPeriod() or the one picked by the last begin(). 0 if the
+            period is automatic and begin() hasn't picked one yet.
+*/
+/**************************************************************************/
+uint32_t Adafruit_FXOS8700_Group::getPeriod() { return _period; }
+
+/**************************************************************************/
+/*!
+    @brief  Checks whether the frame period is picked automatically.
+
+    @return True if begin() picks the period from the sensors' output data
+            rates, false if it was set with setPeriod().
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Group::isAutoPeriod() { return _autoPeriod; }
+
+/**************************************************************************/
+/*!
+    @brief  Starts the read schedule, with the first frame starting now.
+
+            With an automatic period, the period is worked out again from
+            the sensors' current output data rates.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Group::begin() {
+  if (_autoPeriod) {
+    /* The slowest sensor sets the pace, so every frame has fresh data
+       from every sensor */
+    float slowest = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+      float hz = _sensors[i]->getOutputDataRateHz();
+      if (i == 0 || hz < slowest)
+        slowest = hz;
+    }
+    _period = (slowest > 0) ? 1000000.0F / slowest : 0;
+  }
+
+  _next = 0;
+  _valid = 0;
+  _primed = 0;
+  _frameStart = micros();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Runs the read schedule. Call this as often as possible from
+            loop(), it issues at most one burst read per call.
+
+    @param  frame The fxos8700GroupFrame_t to fill in when a frame is
+                  complete.
+
+    @return True if frame was filled with a new frame, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Group::update(fxos8700GroupFrame_t *frame) {
+  if (_count == 0 || _period == 0)
+    return false;
+
+  /* Slot n of the frame starts n/count of the way through the period */
+  uint32_t due =
+      _frameStart + (uint32_t)(((uint64_t)_period * _next) / _count);
+  if ((int32_t)(micros() - due) < 0)
+    return false;
+
+  uint8_t bit = 1 << _next;
+  fxos8700Sample_t sample;
+  if (_sensors[_next]->readSample(&sample)) {
+    if (_valid & bit)
+      _primed |= bit;
+    _previous[_next] = _current[_next];
+    _current[_next] = sample;
+    _valid |= bit;
+  } else {
+    _valid &= ~bit;
+    _primed &= ~bit;
+  }
+
+  if (++_next < _count)
+    return false;
+
+  frame->timestamp = _frameStart;
+  frame->count = _count;
+  frame->valid = _valid;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_valid & (1 << i))
+      alignSample(i, _frameStart, &frame->samples[i]);
+    else
+      memset(&frame->samples[i], 0, sizeof(fxos8700Sample_t));
+  }
+
+  /* Start the next frame, skipping ahead rather than bursting through
+     missed frames if update() wasn't called for a while */
+  _next = 0;
+  _frameStart += _period;
+  if ((int32_t)(micros() - _frameStart) > (int32_t)_period)
+    _frameStart = micros();
+
+  return true;
+}
@@ -0,0 +1,83 @@
+/*!
+ * @file Adafruit_FXOS8700_Group.h
+ *
+ * Read scheduler for several FXOS8700 sensors sharing one or more buses.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __FXOS8700_GROUP_H__
+#define __FXOS8700_GROUP_H__
+
+#include "Adafruit_FXOS8700.h"
+
+#ifndef FXOS8700_GROUP_MAX_SENSORS
+/** Number of sensors an Adafruit_FXOS8700_Group can hold */
+#define FXOS8700_GROUP_MAX_SENSORS (4)
+#endif
+
+/*!
+    @brief  One time-aligned sample from every sensor in a group.
+*/
+typedef struct {
+  uint32_t timestamp; /**< micros() every sample is aligned to */
+  uint8_t count;      /**< Number of sensors in the frame */
+  uint8_t valid;      /**< Bit n is set if sensor n was read successfully */
+  fxos8700Sample_t
+      samples[FXOS8700_GROUP_MAX_SENSORS]; /**< Samples in the order the
+                                                sensors were added */
+} fxos8700GroupFrame_t;
+
+/**************************************************************************/
+/*!
+    @brief  Schedules the burst reads of several FXOS8700 sensors and
+            assembles time-aligned frames.
+
+            Each frame period is split into one slot per sensor, and
+            update() issues at most one burst read per call, when the next
+            slot is due. The bus load is therefore spread evenly over the
+            period instead of arriving as one block of back to back reads.
+
+            Since the reads happen at different points in the period, each
+            sensor's sample is linearly interpolated between its previous
+            and current read to the start of the frame, so all samples in a
+            frame describe the same instant.
+
+            The sensors are not owned by the group. Each has to be set up
+            with begin() or begin_SPI() and configured before being added.
+*/
+/**************************************************************************/
+class Adafruit_FXOS8700_Group {
+public:
+  Adafruit_FXOS8700_Group();
+
+  bool add(Adafruit_FXOS8700 *sensor);
+  uint8_t getCount();
+
+  void setPeriod(uint32_t period_us);
+  uint32_t getPeriod();
+  bool isAutoPeriod();
+
+  void begin();
+  bool update(fxos8700GroupFrame_t *frame);
+
+private:
+  void alignSample(uint8_t index, uint32_t timestamp, fxos8700Sample_t *out);
+
+  Adafruit_FXOS8700 *_sensors[FXOS8700_GROUP_MAX_SENSORS];
+  fxos8700Sample_t _previous[FXOS8700_GROUP_MAX_SENSORS];
+  fxos8700Sample_t _current[FXOS8700_GROUP_MAX_SENSORS];
+  uint8_t _count = 0;
+  uint8_t _next = 0;        ///< Sensor whose slot comes next
+  uint8_t _valid = 0;       ///< Sensors whose last read succeeded
+  uint8_t _primed = 0;      ///< Sensors with a previous read to align with
+  uint32_t _period = 0;     ///< Frame period in microseconds in use
+  bool _autoPeriod = true;  ///< _period is picked by begin()
+  uint32_t _frameStart = 0; ///< micros() the current frame started
+};
+
+#endif
@@ -0,0 +1,613 @@
+/*!
+ * @file Adafruit_FXOS8700_Mock.cpp
+ *
+ * Simulated FXOS8700 behind the register transport interface, see
+ * Adafruit_FXOS8700_Mock.h.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#include "Adafruit_FXOS8700_Mock.h"
+
+/** Output data period of each CTRL_REG1 dr[2:0] value with a single
+ * sensor enabled, in microseconds. Hybrid mode takes twice as long */
+static const uint32_t SAMPLE_PERIOD_US[8] = {1250,  2500,  5000,   10000,
+                                             20000, 80000, 160000, 640000};
+
+/**************************************************************************/
+/*!
+    @brief  Writes accelerometer counts the way the output registers hold
+            them, 14-bit and left-aligned.
+
+    @param  accel The counts.
+    @param  out The 6 bytes to write, OUT_X_MSB to OUT_Z_LSB.
+*/
+/**************************************************************************/
+static void packAccel(const fxos8700RawData_t &accel, uint8_t *out) {
+  int16_t axes[3] = {accel.x, accel.y, accel.z};
+  for (uint8_t i = 0; i < 3; i++) {
+    uint16_t value = (uint16_t)axes[i] << 2;
+    out[2 * i] = value >> 8;
+    out[2 * i + 1] = value & 0xFF;
+  }
+}
+
+/***************************************************************************
+ PRIVATE FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Reads one register the way the sensor would, with the side
+            effects of the read.
+
+    @param  reg The register address.
+
+    @return The register value.
+*/
+/**************************************************************************/
+uint8_t Adafruit_FXOS8700_Mock::readRegister(uint8_t reg) {
+  if (reg == FXOS8700_REGISTER_STATUS && fifoEnabled()) {
+    /* Reading F_STATUS acknowledges src_fifo */
+    _regs[FXOS8700_REGISTER_INT_SOURCE] &= ~0x40;
+    return fifoStatus();
+  }
+
+  if (reg >= FXOS8700_REGISTER_OUT_X_MSB &&
+      reg <= FXOS8700_REGISTER_OUT_Z_LSB) {
+    /* With the FIFO on every pass over OUT_X_MSB takes the next sample */
+    if (fifoEnabled()) {
+      if (reg == FXOS8700_REGISTER_OUT_X_MSB)
+        popFifo();
+    } else {
+      _regs[FXOS8700_REGISTER_STATUS] = 0x00;
+      _regs[FXOS8700_REGISTER_INT_SOURCE] &= ~0x01;
+    }
+  }
+
+  if (reg >= FXOS8700_REGISTER_MOUT_X_MSB &&
+      reg <= FXOS8700_REGISTER_MOUT_Z_LSB)
+    _regs[FXOS8700_REGISTER_MSTATUS] = 0x00;
+
+  return _regs[reg];
+}
+
+/**************************************************************************/
+/*!
+    @brief  Writes one register the way the sensor would, ignoring
+            read-only registers and acting on the self-clearing bits.
+
+    @param  reg The register address.
+    @param  value The value written.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::writeRegister(uint8_t reg, uint8_t value) {
+  bool active = _regs[FXOS8700_REGISTER_CTRL_REG1] & 0x01;
+
+  switch (reg) {
+  case (FXOS8700_REGISTER_STATUS):
+  case (FXOS8700_REGISTER_OUT_X_MSB):
+  case (FXOS8700_REGISTER_OUT_X_LSB):
+  case (FXOS8700_REGISTER_OUT_Y_MSB):
+  case (FXOS8700_REGISTER_OUT_Y_LSB):
+  case (FXOS8700_REGISTER_OUT_Z_MSB):
+  case (FXOS8700_REGISTER_OUT_Z_LSB):
+  case (FXOS8600_REGISTER_SYSMOD):
+  case (FXOS8700_REGISTER_INT_SOURCE):
+  case (FXOS8700_REGISTER_WHO_AM_I):
+  case (FXOS8700_REGISTER_PL_STATUS):
+  case (FXOS8700_REGISTER_A_FFMT_SRC):
+  case (FXOS8700_REGISTER_TRANSIENT_SRC):
+  case (FXOS8700_REGISTER_PULSE_SRC):
+  case (FXOS8700_REGISTER_MSTATUS):
+  case (FXOS8700_REGISTER_MOUT_X_MSB):
+  case (FXOS8700_REGISTER_MOUT_X_LSB):
+  case (FXOS8700_REGISTER_MOUT_Y_MSB):
+  case (FXOS8700_REGISTER_MOUT_Y_LSB):
+  case (FXOS8700_REGISTER_MOUT_Z_MSB):
+  case (FXOS8700_REGISTER_MOUT_Z_LSB):
+  case (FXOS8700_REGISTER_M_THS_SRC):
+  case (FXOS8700_REGISTER_M_INT_SRC):
+    return;
+
+  case (FXOS8700_REGISTER_CTRL_REG1):
+    /* Only the active bit may change outside standby */
+    if (active && ((value ^ _regs[reg]) & ~0x01))
+      _stats.activeWrites++;
+    _regs[reg] = value;
+    _regs[FXOS8600_REGISTER_SYSMOD] = (value & 0x01) ? 0x01 : 0x00;
+    if (!(value & 0x01))
+      _elapsed = 0;
+    return;
+
+  case (FXOS8700_REGISTER_CTRL_REG2):
+    /* rst reloads every register and clears itself */
+    if (value & 0x40) {
+      reset();
+      return;
+    }
+    break;
+
+  case (FXOS8700_REGISTER_XYZ_DATA_CFG):
+  case (FXOS8700_REGISTER_CTRL_REG4):
+  case (FXOS8700_REGISTER_CTRL_REG5):
+    if (active && value != _regs[reg])
+      _stats.activeWrites++;
+    break;
+
+  case (FXOS8700_REGISTER_F_SETUP):
+    /* Disabling the FIFO flushes it */
+    if (!(value & 0xC0)) {
+      _fifoHead = 0;
+      _fifoCount = 0;
+      _fifoOverflow = false;
+    }
+    break;
+
+  case (FXOS8700_REGISTER_MCTRL_REG1):
+    /* m_rst and m_ost clear themselves */
+    value &= ~0x60;
+    break;
+
+  case (FXOS8700_REGISTER_MCTRL_REG2):
+    /* m_maxmin_rst clears itself */
+    value &= ~0x04;
+    break;
+  }
+
+  _regs[reg] = value;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the register a burst moves on to, following the sensor's
+            auto-increment rules.
+
+    @param  reg The register just accessed.
+
+    @return The next register address.
+*/
+/**************************************************************************/
+uint8_t Adafruit_FXOS8700_Mock::nextRegister(uint8_t reg) {
+  /* With the FIFO on, reads loop over the accelerometer output so a long
+     burst drains several samples */
+  if (reg == FXOS8700_REGISTER_OUT_Z_LSB && fifoEnabled())
+    return FXOS8700_REGISTER_OUT_X_MSB;
+
+  /* hyb_autoinc_mode joins the accelerometer and magnetometer outputs */
+  if (_regs[FXOS8700_REGISTER_MCTRL_REG2] & 0x20) {
+    if (reg == FXOS8700_REGISTER_OUT_Z_LSB)
+      return FXOS8700_REGISTER_MOUT_X_MSB;
+    if (reg == FXOS8700_REGISTER_MOUT_Z_LSB)
+      return FXOS8700_REGISTER_STATUS;
+  }
+
+  return (reg + 1) & (FXOS8700_MOCK_REGISTERS - 1);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks the FIFO mode bits in F_SETUP.
+
+    @return True if the FIFO is enabled, otherwise false.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Mock::fifoEnabled() {
+  return _regs[FXOS8700_REGISTER_F_SETUP] & 0xC0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Builds F_STATUS from the FIFO state.
+
+    @return f_ovf, f_wmrk_flag and f_cnt[5:0].
+*/
+/**************************************************************************/
+uint8_t Adafruit_FXOS8700_Mock::fifoStatus() {
+  uint8_t watermark = _regs[FXOS8700_REGISTER_F_SETUP] & 0x3F;
+  uint8_t status = _fifoCount;
+
+  if (_fifoOverflow)
+    status |= 0x80;
+  if (watermark && _fifoCount >= watermark)
+    status |= 0x40;
+  return status;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds an accelerometer sample to the FIFO, as set by the f_mode
+            bits. Trigger mode is treated as circular, since the trigger
+            sources aren't simulated.
+
+    @param  accel The sample.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::pushFifo(const fxos8700RawData_t &accel) {
+  fxos8700FifoMode_t mode =
+      (fxos8700FifoMode_t)(_regs[FXOS8700_REGISTER_F_SETUP] >> 6);
+
+  if (_fifoCount == FXOS8700_FIFO_SIZE) {
+    _fifoOverflow = true;
+    _stats.overruns++;
+    if (mode == FIFO_MODE_STOP)
+      return;
+    _fifoHead = (_fifoHead + 1) % FXOS8700_FIFO_SIZE;
+    _fifoCount--;
+  }
+
+  _fifo[(_fifoHead + _fifoCount) % FXOS8700_FIFO_SIZE] = accel;
+  _fifoCount++;
+
+  if (fifoStatus() & 0xC0)
+    _regs[FXOS8700_REGISTER_INT_SOURCE] |= 0x40;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Moves the oldest FIFO sample into the output registers. The
+            registers keep the last sample once the FIFO is empty.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::popFifo() {
+  if (_fifoCount == 0)
+    return;
+
+  packAccel(_fifo[_fifoHead], &_regs[FXOS8700_REGISTER_OUT_X_MSB]);
+
+  _fifoHead = (_fifoHead + 1) % FXOS8700_FIFO_SIZE;
+  _fifoCount--;
+  _fifoOverflow = false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Makes a new accelerometer sample available, in the output
+            registers or the FIFO.
+
+    @param  accel The sample.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::latchAccel(const fxos8700RawData_t &accel) {
+  if (fifoEnabled()) {
+    pushFifo(accel);
+    return;
+  }
+
+  packAccel(accel, &_regs[FXOS8700_REGISTER_OUT_X_MSB]);
+
+  /* zyxow and the per axis overwrite bits if the last sample wasn't read */
+  uint8_t &status = _regs[FXOS8700_REGISTER_STATUS];
+  if (status & 0x08) {
+    status |= 0xF0;
+    _stats.overruns++;
+  }
+  status |= 0x0F;
+  _regs[FXOS8700_REGISTER_INT_SOURCE] |= 0x01;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Makes a new magnetometer sample available in the output
+            registers.
+
+    @param  mag The sample.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::latchMag(const fxos8700RawData_t &mag) {
+  int16_t axes[3] = {mag.x, mag.y, mag.z};
+  for (uint8_t i = 0; i < 3; i++) {
+    _regs[FXOS8700_REGISTER_MOUT_X_MSB + 2 * i] = (uint16_t)axes[i] >> 8;
+    _regs[FXOS8700_REGISTER_MOUT_X_LSB + 2 * i] = axes[i] & 0xFF;
+  }
+
+  uint8_t &status = _regs[FXOS8700_REGISTER_MSTATUS];
+  if (status & 0x08) {
+    status |= 0xF0;
+    _stats.overruns++;
+  }
+  status |= 0x0F;
+}
+
+/***************************************************************************
+ CONSTRUCTOR
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Instantiates a mock in its power-on state, lying flat at +/- 2g
+            in a 44uT field dipping 60 degrees down towards north.
+*/
+/**************************************************************************/
+Adafruit_FXOS8700_Mock::Adafruit_FXOS8700_Mock() {
+  _accel.x = 0;
+  _accel.y = 0;
+  _accel.z = 4096;
+  _mag.x = 220;
+  _mag.y = 0;
+  _mag.z = -381;
+
+  resetStats();
+  reset();
+}
+
+/***************************************************************************
+ PUBLIC FUNCTIONS
+ ***************************************************************************/
+
+/**************************************************************************/
+/*!
+    @brief  Starts the transport. Like reconnecting the bus to a real
+            sensor, the registers are left as they are.
+
+    @return Always true.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Mock::begin() { return true; }
+
+/**************************************************************************/
+/*!
+    @brief  Burst reads consecutive registers, following the sensor's
+            auto-increment rules.
+
+    @param  reg The first register address.
+    @param  buffer The buffer the register values are read into.
+    @param  len The number of registers to read.
+
+    @return True if the transfer was successful, false if it was failed by
+            failTransfers().
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Mock::read(uint8_t reg, uint8_t *buffer, size_t len) {
+  if (_failures) {
+    _failures--;
+    _stats.failures++;
+    return false;
+  }
+
+  _stats.reads++;
+  _stats.bytesRead += len;
+
+  reg &= FXOS8700_MOCK_REGISTERS - 1;
+  for (size_t i = 0; i < len; i++) {
+    buffer[i] = readRegister(reg);
+    reg = nextRegister(reg);
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Burst writes consecutive registers.
+
+    @param  reg The first register address.
+    @param  buffer The register values to write.
+    @param  len The number of registers to write.
+
+    @return True if the transfer was successful, false if it was failed by
+            failTransfers().
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Mock::write(uint8_t reg, const uint8_t *buffer,
+                                   size_t len) {
+  if (_failures) {
+    _failures--;
+    _stats.failures++;
+    return false;
+  }
+
+  _stats.writes++;
+  _stats.bytesWritten += len;
+
+  reg &= FXOS8700_MOCK_REGISTERS - 1;
+  for (size_t i = 0; i < len; i++) {
+    writeRegister(reg, buffer[i]);
+    reg = (reg + 1) & (FXOS8700_MOCK_REGISTERS - 1);
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns every register to its reset value and empties the FIFO,
+            as a CTRL_REG2 rst does. The sample source and the counters are
+            kept.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::reset() {
+  memset(_regs, 0, sizeof(_regs));
+  _regs[FXOS8700_REGISTER_WHO_AM_I] = FXOS8700_ID;
+  _regs[FXOS8700_REGISTER_PL_CFG] = 0x80;
+  _regs[0x13] = 0x44; /* PL_BF_ZCOMP */
+  _regs[0x14] = 0x84; /* PL_THS_REG */
+
+  _fifoHead = 0;
+  _fifoCount = 0;
+  _fifoOverflow = false;
+  _elapsed = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads a register without the side effects of a bus read, e.g.
+            to check what the driver configured.
+
+    @param  reg The register address.
+
+    @return The stored register value. STATUS is DR_STATUS even while the
+            FIFO is on.
+*/
+/**************************************************************************/
+uint8_t Adafruit_FXOS8700_Mock::getRegister(uint8_t reg) {
+  return _regs[reg & (FXOS8700_MOCK_REGISTERS - 1)];
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets a register directly, bypassing the read-only and
+            self-clearing rules, e.g. to raise an embedded function's
+            source flags.
+
+    @param  reg The register address.
+    @param  value The new value.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::setRegister(uint8_t reg, uint8_t value) {
+  _regs[reg & (FXOS8700_MOCK_REGISTERS - 1)] = value;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the sample tick() latches, replacing any trace.
+
+    @param  accel The accelerometer counts, 14-bit.
+    @param  mag The magnetometer counts.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::setSample(const fxos8700RawData_t &accel,
+                                       const fxos8700RawData_t &mag) {
+  _accel = accel;
+  _mag = mag;
+  _trace = NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Replays a recorded trace, one sample per tick(). Only the
+            accel and mag counts are used, the timestamps and status are
+            ignored since the output data rate paces the replay.
+
+    @param  trace The samples. They are not copied, so the array has to
+                  outlive the replay.
+    @param  count The number of samples in trace.
+    @param  loop Set to true to start over after the last sample, otherwise
+                 tick() stops producing samples.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::setTrace(const fxos8700Sample_t *trace,
+                                      size_t count, bool loop) {
+  _trace = count ? trace : NULL;
+  _traceCount = count;
+  _traceIndex = 0;
+  _traceLoop = loop;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Latches the next sample for every sensor enabled by m_hms,
+            as the sensor does once per output data period. Does nothing
+            in standby.
+
+    @return True if a sample was latched, false in standby or at the end
+            of a trace that doesn't loop.
+*/
+/**************************************************************************/
+bool Adafruit_FXOS8700_Mock::tick() {
+  if (!(_regs[FXOS8700_REGISTER_CTRL_REG1] & 0x01))
+    return false;
+
+  const fxos8700RawData_t *accel = &_accel;
+  const fxos8700RawData_t *mag = &_mag;
+  if (_trace) {
+    if (_traceIndex >= _traceCount) {
+      if (!_traceLoop)
+        return false;
+      _traceIndex = 0;
+    }
+    accel = &_trace[_traceIndex].accel;
+    mag = &_trace[_traceIndex].mag;
+    _traceIndex++;
+  }
+
+  fxos8700SensorMode_t mode =
+      (fxos8700SensorMode_t)(_regs[FXOS8700_REGISTER_MCTRL_REG1] & 0x03);
+  if (mode != MAG_ONLY_MODE)
+    latchAccel(*accel);
+  if (mode != ACCEL_ONLY_MODE)
+    latchMag(*mag);
+
+  _stats.samples++;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Latches the samples due in elapsed time at the configured
+            output data rate, e.g. with the micros() since the last call
+            to run the mock in real time.
+
+    @param  elapsed_us The time that passed, in microseconds. Time spent in
+                       standby is dropped.
+
+    @return The number of samples latched.
+*/
+/**************************************************************************/
+uint32_t Adafruit_FXOS8700_Mock::advance(uint32_t elapsed_us) {
+  if (!(_regs[FXOS8700_REGISTER_CTRL_REG1] & 0x01))
+    return 0;
+
+  uint32_t period = getSamplePeriod();
+  uint32_t count = 0;
+
+  _elapsed += elapsed_us;
+  while (_elapsed >= period) {
+    _elapsed -= period;
+    if (tick())
+      count++;
+  }
+  return count;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the output data period set by the dr and m_hms bits. The
+            auto-sleep rate isn't simulated, so this is always the wake
+            rate.
+
+    @return The time between samples in microseconds.
+*/
+/**************************************************************************/
+uint32_t Adafruit_FXOS8700_Mock::getSamplePeriod() {
+  uint32_t period =
+      SAMPLE_PERIOD_US[(_regs[FXOS8700_REGISTER_CTRL_REG1] >> 3) & 0x07];
+
+  if ((_regs[FXOS8700_REGISTER_MCTRL_REG1] & 0x03) == HYBRID_MODE)
+    period *= 2;
+  return period;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Makes the next transfers fail, to exercise the driver's retry
+            policy and recover().
+
+    @param  count The number of transfers to fail, reads and writes alike.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::failTransfers(uint8_t count) {
+  _failures = count;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the transfer and sample counters.
+
+    @param  stats The struct to copy the counters into.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::getStats(fxos8700MockStats_t *stats) {
+  *stats = _stats;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Clears the transfer and sample counters.
+*/
+/**************************************************************************/
+void Adafruit_FXOS8700_Mock::resetStats() {
+  memset(&_stats, 0, sizeof(_stats));
+}
@@ -0,0 +1,106 @@
+/*!
+ * @file Adafruit_FXOS8700_Mock.h
+ *
+ * Simulated FXOS8700 behind the register transport interface, for running
+ * the driver and sketches without a sensor attached.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __FXOS8700_MOCK_H__
+#define __FXOS8700_MOCK_H__
+
+#include "Adafruit_FXOS8700.h"
+
+/** Number of registers modelled by Adafruit_FXOS8700_Mock, 0x00 to 0x7F */
+#define FXOS8700_MOCK_REGISTERS (0x80)
+
+/*!
+    @brief  Counters kept by Adafruit_FXOS8700_Mock
+*/
+typedef struct {
+  uint32_t reads;        /**< Read transfers */
+  uint32_t writes;       /**< Write transfers */
+  uint32_t bytesRead;    /**< Registers read */
+  uint32_t bytesWritten; /**< Registers written */
+  uint32_t failures;     /**< Transfers failed by failTransfers() */
+  uint32_t samples;      /**< Samples latched by tick() */
+  uint32_t overruns;     /**< Samples latched before the previous was read */
+  uint32_t activeWrites; /**< Writes to settings that need standby, made
+                              while active */
+} fxos8700MockStats_t;
+
+/**************************************************************************/
+/*!
+    @brief  Simulated FXOS8700 to pass to Adafruit_FXOS8700::begin_Transport().
+
+            The mock holds the full register file and follows the parts
+            of the datasheet the driver relies on: WHO_AM_I, SYSMOD
+            following the active bit, the zyxdr/zyxow bits of DR_STATUS and
+            M_DR_STATUS, src_drdy and src_fifo in INT_SOURCE, the 32 sample
+            accelerometer FIFO with F_STATUS at 0x00, the hybrid
+            auto-increment jump from 0x06 to 0x33, the CTRL_REG2 soft reset
+            and the read-only registers.
+
+            Samples come from setSample() or a recorded trace, e.g. one
+            captured with readSample() or decoded from an
+            Adafruit_FXOS8700_FrameDecoder, and are latched one output data
+            period at a time by tick(), or in real time by advance(). The
+            values are the output registers as is, offsets, filters and the
+            embedded functions are not simulated.
+*/
+/**************************************************************************/
+class Adafruit_FXOS8700_Mock : public Adafruit_FXOS8700_Transport {
+public:
+  Adafruit_FXOS8700_Mock();
+
+  bool begin();
+  bool read(uint8_t reg, uint8_t *buffer, size_t len);
+  bool write(uint8_t reg, const uint8_t *buffer, size_t len);
+
+  void reset();
+  uint8_t getRegister(uint8_t reg);
+  void setRegister(uint8_t reg, uint8_t value);
+
+  void setSample(const fxos8700RawData_t &accel, const fxos8700RawData_t &mag);
+  void setTrace(const fxos8700Sample_t *trace, size_t count, bool loop = true);
+  bool tick();
+  uint32_t advance(uint32_t elapsed_us);
+  uint32_t getSamplePeriod();
+
+  void failTransfers(uint8_t count);
+  void getStats(fxos8700MockStats_t *stats);
+  void resetStats();
+
+private:
+  uint8_t readRegister(uint8_t reg);
+  void writeRegister(uint8_t reg, uint8_t value);
+  uint8_t nextRegister(uint8_t reg);
+  bool fifoEnabled();
+  uint8_t fifoStatus();
+  void pushFifo(const fxos8700RawData_t &accel);
+  void popFifo();
+  void latchAccel(const fxos8700RawData_t &accel);
+  void latchMag(const fxos8700RawData_t &mag);
+
+  uint8_t _regs[FXOS8700_MOCK_REGISTERS];
+  fxos8700RawData_t _fifo[FXOS8700_FIFO_SIZE];
+  uint8_t _fifoHead = 0;      ///< Index of the oldest FIFO sample
+  uint8_t _fifoCount = 0;     ///< Samples in the FIFO
+  bool _fifoOverflow = false; ///< A sample was lost since the FIFO filled
+  fxos8700RawData_t _accel;   ///< Sample used without a trace
+  fxos8700RawData_t _mag;     ///< Sample used without a trace
+  const fxos8700Sample_t *_trace = NULL;
+  size_t _traceCount = 0;
+  size_t _traceIndex = 0; ///< Next trace sample tick() latches
+  bool _traceLoop = false;
+  uint32_t _elapsed = 0; ///< Time advance() hasn't turned into a sample yet
+  uint8_t _failures = 0; ///< Transfers left for failTransfers() to fail
+  fxos8700MockStats_t _stats;
+};
+
+#endif
@@ -0,0 +1,274 @@
+/*!
+ * @file Adafruit_FXOS8700_Static.h
+ *
+ * Compile-time configured variant of Adafruit's FXOS8700 driver, for boards
+ * where the sensor mode, range and output data rate never change.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __FXOS8700_STATIC_H__
+#define __FXOS8700_STATIC_H__
+
+#include "Adafruit_FXOS8700.h"
+
+/**************************************************************************/
+/*!
+    @brief  FXOS8700 driver with its configuration fixed at compile time.
+
+            Every register value, the unit scale factors and the burst read
+            covering the enabled sensors are constant expressions, so the
+            read path is one transfer of a fixed length and a decode with no
+            mode, range or rate checks left in it. An output data rate that
+            isn't available in the chosen mode fails to compile.
+
+            This class doesn't derive from Adafruit_Sensor, which keeps the
+            vtable out of flash. Use Adafruit_FXOS8700 where the settings
+            are changed at runtime, or the Adafruit_Sensor API is needed.
+
+    @tparam Mode The sensor mode.
+    @tparam Range The accelerometer range.
+    @tparam Rate The output data rate, must be available in Mode.
+    @tparam Ratio The magnetometer oversampling ratio.
+    @tparam LowNoise Enables low noise mode, ignored in 8g range.
+*/
+/**************************************************************************/
+template <fxos8700SensorMode_t Mode, fxos8700AccelRange_t Range,
+          fxos8700ODR_t Rate, fxos8700MagOSR_t Ratio = MAG_OSR_7,
+          bool LowNoise = true>
+class Adafruit_FXOS8700_Static {
+public:
+  /*!
+      @brief  Instantiates a new Adafruit_FXOS8700_Static class.
+      @param  accelSensorID The unique ID to give to accelerometer events.
+      @param  magSensorID The unique ID to give to magnetometer events.
+  */
+  Adafruit_FXOS8700_Static(int32_t accelSensorID = -1,
+                           int32_t magSensorID = -1)
+      : _accelSensorID(accelSensorID), _magSensorID(magSensorID) {
+    static_assert(drBits() != FXOS8700_ODR_UNSUPPORTED,
+                  "Output data rate isn't available in this sensor mode");
+  }
+
+  ~Adafruit_FXOS8700_Static() {
+    if (i2c_dev)
+      delete i2c_dev;
+  }
+
+  /*! @brief  Gets the sensor mode. @return The Mode parameter. */
+  static constexpr fxos8700SensorMode_t getSensorMode() { return Mode; }
+  /*! @brief  Gets the accelerometer range. @return The Range parameter. */
+  static constexpr fxos8700AccelRange_t getAccelRange() { return Range; }
+  /*! @brief  Gets the output data rate. @return The Rate parameter. */
+  static constexpr fxos8700ODR_t getOutputDataRate() { return Rate; }
+  /*! @brief  Gets the rate each enabled sensor is sampled at.
+      @return The output data rate in Hz. */
+  static constexpr float getOutputDataRateHz() {
+    return FXOS8700_DR_HZ[drBits() >> 3] / ((Mode == HYBRID_MODE) ? 2 : 1);
+  }
+  /*! @brief  Gets the magnetometer oversampling ratio.
+      @return The Ratio parameter. */
+  static constexpr fxos8700MagOSR_t getMagOversamplingRatio() { return Ratio; }
+
+  /*! @brief  Checks if the accelerometer is enabled.
+      @return True unless in mag-only mode. */
+  static constexpr bool hasAccel() { return Mode != MAG_ONLY_MODE; }
+  /*! @brief  Checks if the magnetometer is enabled.
+      @return True unless in accel-only mode. */
+  static constexpr bool hasMag() { return Mode != ACCEL_ONLY_MODE; }
+
+  /*! @brief  Gets the CTRL_REG1 value, without the active bit.
+      @return dr[2:0] and lnoise. */
+  static constexpr uint8_t ctrlReg1() {
+    return drBits() | ((LowNoise && Range != ACCEL_RANGE_8G) ? 0x04 : 0x00);
+  }
+  /*! @brief  Gets the CTRL_REG2 value.
+      @return mods[1:0] set to high resolution. */
+  static constexpr uint8_t ctrlReg2() { return 0x02; }
+  /*! @brief  Gets the XYZ_DATA_CFG value.
+      @return fs[1:0]. */
+  static constexpr uint8_t xyzDataCfg() { return Range; }
+  /*! @brief  Gets the MCTRL_REG1 value.
+      @return m_os[2:0] and m_hms[1:0]. */
+  static constexpr uint8_t mctrlReg1() { return (Ratio << 2) | Mode; }
+  /*! @brief  Gets the MCTRL_REG2 value.
+      @return hyb_autoinc_mode, set in hybrid mode. */
+  static constexpr uint8_t mctrlReg2() {
+    return (Mode == HYBRID_MODE) ? 0x20 : 0x00;
+  }
+
+  /*! @brief  Gets the first register of the burst read.
+      @return M_DR_STATUS in mag-only mode, otherwise STATUS. */
+  static constexpr uint8_t burstRegister() {
+    return (Mode == MAG_ONLY_MODE) ? FXOS8700_REGISTER_MSTATUS
+                                   : FXOS8700_REGISTER_STATUS;
+  }
+  /*! @brief  Gets the length of the burst read, including the status byte.
+      @return 13 in hybrid mode, otherwise 7. */
+  static constexpr uint8_t burstLength() {
+    return (Mode == HYBRID_MODE) ? 13 : 7;
+  }
+
+  /*! @brief  Gets the accelerometer scale factor.
+      @return m/s^2 per LSB. */
+  static constexpr float accelScale() {
+    return ((Range == ACCEL_RANGE_2G)   ? ACCEL_MG_LSB_2G
+            : (Range == ACCEL_RANGE_4G) ? ACCEL_MG_LSB_4G
+                                        : ACCEL_MG_LSB_8G) *
+           SENSORS_GRAVITY_STANDARD;
+  }
+  /*! @brief  Gets the magnetometer scale factor.
+      @return uT per LSB. */
+  static constexpr float magScale() { return MAG_UT_LSB; }
+
+  /*!
+      @brief  Sets up the hardware and writes the configuration.
+      @param  addr The I2C address of the sensor.
+      @param  wire The Wire object to be used for I2C connections.
+      @return True if initialization was successful, otherwise false.
+  */
+  bool begin(uint8_t addr = 0x1F, TwoWire *wire = &Wire) {
+    if (i2c_dev)
+      delete i2c_dev;
+    i2c_dev = new Adafruit_I2CDevice(addr, wire);
+    if (!i2c_dev->begin())
+      return false;
+
+    uint8_t id;
+    if (!readRegisters(FXOS8700_REGISTER_WHO_AM_I, &id, 1) ||
+        id != FXOS8700_ID)
+      return false;
+
+    /* The configuration registers only take writes in standby. Everything
+       else is cleared in case a previous run left it configured */
+    const uint8_t ctrl[] = {ctrlReg2(), 0x00, 0x00, 0x00};
+    const uint8_t mctrl[] = {mctrlReg1(), mctrlReg2(), 0x00};
+    return writeRegister(FXOS8700_REGISTER_CTRL_REG1, 0x00) &&
+           waitForSystemMode(true) &&
+           writeRegister(FXOS8700_REGISTER_XYZ_DATA_CFG, xyzDataCfg()) &&
+           writeRegister(FXOS8700_REGISTER_F_SETUP, 0x00) &&
+           writeRegisters(FXOS8700_REGISTER_CTRL_REG2, ctrl, sizeof(ctrl)) &&
+           writeRegisters(FXOS8700_REGISTER_MCTRL_REG1, mctrl,
+                          sizeof(mctrl)) &&
+           writeRegister(FXOS8700_REGISTER_CTRL_REG1, ctrlReg1() | 0x01) &&
+           waitForSystemMode(false);
+  }
+
+  /*!
+      @brief  Reads the most recent raw samples in one burstLength() read.
+      @param  accel The fxos8700RawData_t for the accelerometer counts, or
+              NULL. Ignored in mag-only mode.
+      @param  mag The fxos8700RawData_t for the magnetometer counts, or NULL.
+              Ignored in accel-only mode.
+      @param  status Set to the status byte at the start of the burst, or
+              NULL.
+      @return True if the read was successful, otherwise false.
+  */
+  bool readRaw(fxos8700RawData_t *accel, fxos8700RawData_t *mag,
+               uint8_t *status = NULL) {
+    uint8_t buffer[burstLength()];
+    if (!readRegisters(burstRegister(), buffer, sizeof(buffer)))
+      return false;
+
+    if (status)
+      *status = buffer[0];
+    if (hasAccel() && accel)
+      fxos8700DecodeAccel(buffer + 1, accel);
+    if (hasMag() && mag)
+      fxos8700DecodeMag(buffer + (hasAccel() ? 7 : 1), mag);
+    return true;
+  }
+
+  /*!
+      @brief  Reads a timestamped sample.
+      @param  sample The fxos8700Sample_t to fill in. Counts for a sensor
+              disabled in Mode are zero.
+      @return True if the read was successful, otherwise false.
+  */
+  bool readSample(fxos8700Sample_t *sample) {
+    *sample = fxos8700Sample_t();
+    sample->timestamp = micros();
+    return readRaw(&sample->accel, &sample->mag, &sample->status);
+  }
+
+  /*!
+      @brief  Gets the most recent sensor events, timestamped with millis().
+      @param  accelEvent The sensors_event_t to fill with the accelerometer
+              reading, or NULL. Ignored in mag-only mode.
+      @param  magEvent The sensors_event_t to fill with the magnetometer
+              reading, or NULL. Ignored in accel-only mode.
+      @return True if the read was successful, otherwise false.
+  */
+  bool getEvent(sensors_event_t *accelEvent, sensors_event_t *magEvent) {
+    fxos8700RawData_t accel, mag;
+    if (!readRaw(&accel, &mag))
+      return false;
+
+    uint32_t timestamp = millis();
+    if (hasAccel() && accelEvent) {
+      memset(accelEvent, 0, sizeof(sensors_event_t));
+      accelEvent->version = sizeof(sensors_event_t);
+      accelEvent->sensor_id = _accelSensorID;
+      accelEvent->type = SENSOR_TYPE_ACCELEROMETER;
+      accelEvent->timestamp = timestamp;
+      accelEvent->acceleration.x = accel.x * accelScale();
+      accelEvent->acceleration.y = accel.y * accelScale();
+      accelEvent->acceleration.z = accel.z * accelScale();
+    }
+    if (hasMag() && magEvent) {
+      memset(magEvent, 0, sizeof(sensors_event_t));
+      magEvent->version = sizeof(sensors_event_t);
+      magEvent->sensor_id = _magSensorID;
+      magEvent->type = SENSOR_TYPE_MAGNETIC_FIELD;
+      magEvent->timestamp = timestamp;
+      magEvent->magnetic.x = mag.x * magScale();
+      magEvent->magnetic.y = mag.y * magScale();
+      magEvent->magnetic.z = mag.z * magScale();
+    }
+    return true;
+  }
+
+protected:
+  Adafruit_I2CDevice *i2c_dev = NULL; ///< Pointer to I2C bus interface
+
+private:
+  /* dr[2:0] for Rate in Mode, or FXOS8700_ODR_UNSUPPORTED */
+  static constexpr uint8_t drBits() {
+    return FXOS8700_ODR_DR_BITS[Mode == HYBRID_MODE][Rate];
+  }
+
+  bool readRegisters(uint8_t reg, uint8_t *buffer, size_t len) {
+    return i2c_dev->write_then_read(&reg, 1, buffer, len);
+  }
+
+  bool writeRegisters(uint8_t reg, const uint8_t *buffer, size_t len) {
+    return i2c_dev->write(buffer, len, true, &reg, 1);
+  }
+
+  bool writeRegister(uint8_t reg, uint8_t value) {
+    return writeRegisters(reg, &value, 1);
+  }
+
+  /* Polls sysmod[1:0] until the sensor enters or leaves standby */
+  bool waitForSystemMode(bool standby) {
+    uint32_t start = micros();
+    uint8_t sysmod;
+    while (readRegisters(FXOS8600_REGISTER_SYSMOD, &sysmod, 1)) {
+      if (((sysmod & 0x03) == STANDBY) == standby)
+        return true;
+      if ((uint32_t)(micros() - start) >= FXOS8700_STANDBY_TIMEOUT_US)
+        return false;
+      delayMicroseconds(FXOS8700_STANDBY_POLL_US);
+    }
+    return false;
+  }
+
+  int32_t _accelSensorID;
+  int32_t _magSensorID;
+};
+
+#endif
@@ -0,0 +1,198 @@
+/* Sustained throughput benchmark for the FXOS8700.
+
+   For every sensor mode, output data rate and I2C clock this measures, per
+   read path, the achieved sample rate, the number of duplicate (stale) and
+   dropped samples, and the CPU time spent per read. Results are printed as
+   CSV so runs can be compared across boards and library versions.
+
+   Read paths:
+     getEvent   - getEvent(&accel, &mag), duplicates detected by comparing
+                  the raw values with the previous read
+     readSample - readSample(), duplicates and overruns taken from the
+                  zyxdr/zyxow bits of the status byte in the same burst
+     readFifo   - readFifo() draining the 32 sample accelerometer FIFO
+                  (modes with the accelerometer only)
+
+   Dropped samples are the overruns flagged by the sensor for readSample,
+   and the shortfall against the configured ODR for the other paths.
+*/
+#include <Adafruit_FXOS8700.h>
+
+Adafruit_FXOS8700 accelmag = Adafruit_FXOS8700(0x8700A, 0x8700B);
+
+/* How long each read path is measured for, per configuration */
+#define WINDOW_MS (1000)
+
+/* 1MHz is beyond the FXOS8700's rated 400kHz, kept to find the limit */
+const uint32_t i2cClocks[] = {100000, 400000, 1000000};
+
+const fxos8700SensorMode_t modes[] = {ACCEL_ONLY_MODE, MAG_ONLY_MODE,
+                                      HYBRID_MODE};
+const char *const modeNames[] = {"accel", "mag", "hybrid"};
+
+const fxos8700ODR_t rates[] = {ODR_800HZ,  ODR_400HZ,   ODR_200HZ,
+                               ODR_100HZ,  ODR_50HZ,    ODR_25HZ,
+                               ODR_12_5HZ, ODR_6_25HZ,  ODR_3_125HZ,
+                               ODR_1_5625HZ, ODR_0_7813HZ};
+
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+
+typedef struct {
+  uint32_t calls;      // reads issued
+  uint32_t samples;    // new samples received
+  uint32_t duplicates; // reads that returned a sample already seen
+  uint32_t dropped;    // samples lost
+  uint32_t busy;       // microseconds spent inside the library
+  uint32_t elapsed;    // microseconds the window lasted
+} result_t;
+
+void printRow(const char *path, uint8_t mode, uint32_t clock,
+              const result_t &r) {
+  float seconds = r.elapsed / 1000000.0F;
+
+  Serial.print(path);
+  Serial.print(",");
+  Serial.print(modeNames[mode]);
+  Serial.print(",");
+  Serial.print(accelmag.getOutputDataRateHz(), 4);
+  Serial.print(",");
+  Serial.print(clock);
+  Serial.print(",");
+  Serial.print(r.samples / seconds, 1);
+  Serial.print(",");
+  Serial.print(r.duplicates);
+  Serial.print(",");
+  Serial.print(r.dropped);
+  Serial.print(",");
+  Serial.print(r.calls ? (float)r.busy / r.calls : 0.0F, 1);
+  Serial.print(",");
+  Serial.println(r.samples ? (float)r.busy / r.samples : 0.0F, 1);
+}
+
+/* Samples the ODR should have delivered that weren't received */
+uint32_t shortfall(const result_t &r) {
+  uint32_t expected = accelmag.getOutputDataRateHz() * (r.elapsed / 1000000.0F);
+  return (expected > r.samples) ? expected - r.samples : 0;
+}
+
+result_t benchGetEvent() {
+  result_t r = {0, 0, 0, 0, 0, 0};
+  sensors_event_t aevent, mevent;
+  fxos8700RawData_t lastAccel = {0, 0, 0}, lastMag = {0, 0, 0};
+
+  uint32_t start = micros();
+  while ((uint32_t)(micros() - start) < WINDOW_MS * 1000UL) {
+    uint32_t t0 = micros();
+    bool ok = accelmag.getEvent(&aevent, &mevent);
+    r.busy += micros() - t0;
+    r.calls++;
+    if (!ok)
+      continue;
+
+    if (memcmp(&lastAccel, &accelmag.accel_raw, sizeof(lastAccel)) == 0 &&
+        memcmp(&lastMag, &accelmag.mag_raw, sizeof(lastMag)) == 0) {
+      r.duplicates++;
+    } else {
+      r.samples++;
+      lastAccel = accelmag.accel_raw;
+      lastMag = accelmag.mag_raw;
+    }
+  }
+  r.elapsed = micros() - start;
+  r.dropped = shortfall(r);
+
+  return r;
+}
+
+result_t benchReadSample() {
+  result_t r = {0, 0, 0, 0, 0, 0};
+  fxos8700Sample_t sample;
+
+  uint32_t start = micros();
+  while ((uint32_t)(micros() - start) < WINDOW_MS * 1000UL) {
+    uint32_t t0 = micros();
+    bool ok = accelmag.readSample(&sample);
+    r.busy += micros() - t0;
+    r.calls++;
+    if (!ok)
+      continue;
+
+    /* zyxdr = new data, zyxow = previous sample overwritten unread */
+    if (sample.status & 0x08)
+      r.samples++;
+    else
+      r.duplicates++;
+    if (sample.status & 0x80)
+      r.dropped++;
+  }
+  r.elapsed = micros() - start;
+
+  return r;
+}
+
+result_t benchReadFifo() {
+  result_t r = {0, 0, 0, 0, 0, 0};
+  fxos8700RawData_t samples[FXOS8700_FIFO_SIZE];
+
+  accelmag.setFifoMode(FIFO_MODE_CIRCULAR);
+
+  uint32_t start = micros();
+  while ((uint32_t)(micros() - start) < WINDOW_MS * 1000UL) {
+    uint32_t t0 = micros();
+    size_t count = accelmag.readFifo(samples, FXOS8700_FIFO_SIZE);
+    r.busy += micros() - t0;
+    r.calls++;
+    r.samples += count;
+  }
+  r.elapsed = micros() - start;
+  r.dropped = shortfall(r);
+
+  accelmag.setFifoMode(FIFO_MODE_DISABLED);
+
+  return r;
+}
+
+void setup(void) {
+  Serial.begin(115200);
+
+  /* Wait for the Serial Monitor */
+  while (!Serial) {
+    delay(1);
+  }
+
+  /* Initialise the sensor */
+  if (!accelmag.begin()) {
+    /* There was a problem detecting the FXOS8700 ... check your connections */
+    Serial.println("Ooops, no FXOS8700 detected ... Check your wiring!");
+    while (1)
+      ;
+  }
+
+  Serial.println("path,mode,odr_hz,i2c_hz,samples_per_s,duplicates,dropped,"
+                 "us_per_call,us_per_sample");
+
+  for (uint8_t c = 0; c < COUNT_OF(i2cClocks); c++) {
+    Wire.setClock(i2cClocks[c]);
+
+    for (uint8_t m = 0; m < COUNT_OF(modes); m++) {
+      for (uint8_t o = 0; o < COUNT_OF(rates); o++) {
+        fxos8700Config_t config = FXOS8700_DEFAULT_CONFIG;
+        config.mode = modes[m];
+        config.rate = rates[o];
+
+        /* Not every ODR is available in every mode */
+        if (!accelmag.applyConfig(config))
+          continue;
+
+        printRow("getEvent", m, i2cClocks[c], benchGetEvent());
+        printRow("readSample", m, i2cClocks[c], benchReadSample());
+        if (modes[m] != MAG_ONLY_MODE)
+          printRow("readFifo", m, i2cClocks[c], benchReadFifo());
+      }
+    }
+  }
+
+  Serial.println("done");
+}
+
+void loop(void) { delay(1000); }
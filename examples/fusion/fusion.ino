@@ -0,0 +1,56 @@
+/* Prints the roll, pitch and heading of a FXOS8700, filtered at the sample
+   rate from the raw counts. Define FXOS8700_FUSION_FIXED as 1 in the build
+   flags to run the filter in fixed-point, the printing is the same. */
+#include <Adafruit_FXOS8700.h>
+#include <Adafruit_FXOS8700_Fusion.h>
+
+Adafruit_FXOS8700 accelmag = Adafruit_FXOS8700(0x8700A, 0x8700B);
+Adafruit_FXOS8700_Fusion fusion;
+
+uint32_t lastPrint = 0;
+
+void setup(void) {
+  Serial.begin(115200);
+
+  /* Wait for the Serial Monitor */
+  while (!Serial) {
+    delay(1);
+  }
+
+  Serial.println("FXOS8700 Fusion Test");
+  Serial.println("");
+
+  /* Initialise the sensor */
+  if (!accelmag.begin()) {
+    /* There was a problem detecting the FXOS8700 ... check your connections */
+    Serial.println("Ooops, no FXOS8700 detected ... Check your wiring!");
+    while (1)
+      ;
+  }
+
+  /* The filter step is timed by the rate each sample arrives at */
+  accelmag.setOutputDataRate(ODR_200HZ);
+  fusion.begin(accelmag.getOutputDataRateHz());
+}
+
+void loop(void) {
+  fxos8700Sample_t sample;
+
+  /* Run the filter once for every new sample (zyxdr) */
+  if (accelmag.readSample(&sample) && (sample.status & 0x08))
+    fusion.update(sample);
+
+  if (millis() - lastPrint < 100)
+    return;
+  lastPrint = millis();
+
+  fxos8700Orientation_t orientation;
+  fusion.getOrientation(&orientation);
+
+  Serial.print("Roll: ");
+  Serial.print((float)orientation.roll / FXOS8700_FUSION_SCALE, 1);
+  Serial.print("  Pitch: ");
+  Serial.print((float)orientation.pitch / FXOS8700_FUSION_SCALE, 1);
+  Serial.print("  Heading: ");
+  Serial.println((float)orientation.heading / FXOS8700_FUSION_SCALE, 1);
+}
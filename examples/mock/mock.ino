@@ -0,0 +1,93 @@
+/* Runs the driver against a simulated FXOS8700 instead of a sensor, so it
+   works on a bare board with nothing wired up.
+
+   The mock replays a short trace of the board turning slowly about its Z
+   axis, latching samples in real time at the configured output data rate.
+   Every second this prints the latest sample, the bus transfers the driver
+   made per sample and the CPU time spent in readSample(). */
+#include <Adafruit_FXOS8700.h>
+#include <Adafruit_FXOS8700_Mock.h>
+
+Adafruit_FXOS8700 accelmag = Adafruit_FXOS8700(0x8700A, 0x8700B);
+Adafruit_FXOS8700_Mock mock;
+
+/* One turn, a sample every 10 degrees */
+#define TRACE_LENGTH (36)
+fxos8700Sample_t trace[TRACE_LENGTH];
+
+uint32_t lastAdvance = 0;
+uint32_t lastPrint = 0;
+uint32_t samples = 0;
+uint32_t busy = 0;
+fxos8700Sample_t sample;
+
+void setup(void) {
+  Serial.begin(115200);
+
+  /* Wait for the Serial Monitor */
+  while (!Serial) {
+    delay(1);
+  }
+
+  Serial.println("FXOS8700 Mock Test");
+  Serial.println("");
+
+  /* Lying flat at +/- 2g, in a 44uT field dipping 60 degrees */
+  for (uint8_t i = 0; i < TRACE_LENGTH; i++) {
+    float heading = i * 10 * DEG_TO_RAD;
+    trace[i].accel.x = 0;
+    trace[i].accel.y = 0;
+    trace[i].accel.z = 4096;
+    trace[i].mag.x = 220 * cos(heading);
+    trace[i].mag.y = -220 * sin(heading);
+    trace[i].mag.z = -381;
+  }
+  mock.setTrace(trace, TRACE_LENGTH);
+
+  if (!accelmag.begin_Transport(&mock)) {
+    Serial.println("Ooops, the mock didn't initialise!");
+    while (1)
+      ;
+  }
+
+  accelmag.setOutputDataRate(ODR_50HZ);
+  mock.resetStats();
+  lastAdvance = micros();
+}
+
+void loop(void) {
+  /* Let the mock catch up with the time that passed */
+  uint32_t now = micros();
+  mock.advance(now - lastAdvance);
+  lastAdvance = now;
+
+  uint32_t start = micros();
+  bool ok = accelmag.readSample(&sample);
+  busy += micros() - start;
+
+  /* Count the new samples (zyxdr) */
+  if (ok && (sample.status & 0x08))
+    samples++;
+
+  if (millis() - lastPrint < 1000)
+    return;
+  lastPrint = millis();
+
+  fxos8700MockStats_t stats;
+  mock.getStats(&stats);
+
+  Serial.print("Mag X: ");
+  Serial.print(sample.mag.x);
+  Serial.print("  Y: ");
+  Serial.print(sample.mag.y);
+  Serial.print("  Z: ");
+  Serial.print(sample.mag.z);
+  Serial.print("  Samples: ");
+  Serial.print(samples);
+  Serial.print("  Overruns: ");
+  Serial.print(stats.overruns);
+  Serial.print("  Reads/sample: ");
+  Serial.print(samples ? (float)stats.reads / samples : 0.0F, 1);
+  Serial.print("  us/read: ");
+  Serial.println(stats.reads ? (float)busy / stats.reads : 0.0F, 1);
+}
@@ -0,0 +1,71 @@
+/* Reads a FXOS8700 whose configuration is fixed at compile time: hybrid
+   mode, +/- 4g and 200Hz. Changing the template parameters to a rate the
+   mode doesn't support (e.g. ODR_800HZ in hybrid mode) fails to compile. */
+#include <Adafruit_FXOS8700_Static.h>
+
+Adafruit_FXOS8700_Static<HYBRID_MODE, ACCEL_RANGE_4G, ODR_200HZ> accelmag(
+    0x8700A, 0x8700B);
+
+void setup(void) {
+  Serial.begin(9600);
+
+  /* Wait for the Serial Monitor */
+  while (!Serial) {
+    delay(1);
+  }
+
+  Serial.println("FXOS8700 Static Configuration Test");
+  Serial.println("");
+
+  /* Initialise the sensor */
+  if (!accelmag.begin()) {
+    /* There was a problem detecting the FXOS8700 ... check your connections */
+    Serial.println("Ooops, no FXOS8700 detected ... Check your wiring!");
+    while (1)
+      ;
+  }
+
+  Serial.print("Burst read: ");
+  Serial.print(accelmag.burstLength());
+  Serial.println(" bytes");
+}
+
+void loop(void) {
+  sensors_event_t aevent, mevent;
+
+  /* Get a new sensor event, trying again later if the read failed */
+  if (!accelmag.getEvent(&aevent, &mevent)) {
+    delay(500);
+    return;
+  }
+
+  /* Display the accel results (acceleration is measured in m/s^2) */
+  Serial.print("A ");
+  Serial.print("X: ");
+  Serial.print(aevent.acceleration.x, 4);
+  Serial.print("  ");
+  Serial.print("Y: ");
+  Serial.print(aevent.acceleration.y, 4);
+  Serial.print("  ");
+  Serial.print("Z: ");
+  Serial.print(aevent.acceleration.z, 4);
+  Serial.print("  ");
+  Serial.println("m/s^2");
+
+  /* Display the mag results (mag data is in uTesla) */
+  Serial.print("M ");
+  Serial.print("X: ");
+  Serial.print(mevent.magnetic.x, 1);
+  Serial.print("  ");
+  Serial.print("Y: ");
+  Serial.print(mevent.magnetic.y, 1);
+  Serial.print("  ");
+  Serial.print("Z: ");
+  Serial.print(mevent.magnetic.z, 1);
+  Serial.print("  ");
+  Serial.println("uT");
+
+  Serial.println("");
+
+  delay(500);
+}
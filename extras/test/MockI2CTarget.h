@@ -0,0 +1,65 @@
+/*!
+ * @file MockI2CTarget.h
+ *
+ * Puts an Adafruit_FXOS8700_Mock on the host I2C bus in shim/Wire.h, for
+ * code that talks to the sensor through begin() and Adafruit_I2CDevice
+ * rather than begin_Transport().
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __MOCK_I2C_TARGET_H__
+#define __MOCK_I2C_TARGET_H__
+
+#include "Adafruit_FXOS8700_Mock.h"
+#include <Wire.h>
+
+/*!
+    @brief  Adapts an Adafruit_FXOS8700_Mock to a device on a TwoWire,
+            latching the samples due as the host clock moves on.
+*/
+class MockI2CTarget : public HostI2CTarget {
+public:
+  /*!
+      @brief  Instantiates a new MockI2CTarget.
+      @param  mock The simulated sensor.
+  */
+  MockI2CTarget(Adafruit_FXOS8700_Mock *mock) : _mock(mock), _last(micros()) {}
+
+  /*!
+      @brief  Reads registers from the mock.
+      @param  reg The first register.
+      @param  buffer The buffer to read into.
+      @param  len The number of registers.
+      @return The mock's result.
+  */
+  bool read(uint8_t reg, uint8_t *buffer, size_t len) {
+    catchUp();
+    return _mock->read(reg, buffer, len);
+  }
+
+  /*!
+      @brief  Writes registers to the mock.
+      @param  reg The first register.
+      @param  buffer The values to write.
+      @param  len The number of registers.
+      @return The mock's result.
+  */
+  bool write(uint8_t reg, const uint8_t *buffer, size_t len) {
+    catchUp();
+    return _mock->write(reg, buffer, len);
+  }
+
+private:
+  /* Latch the samples due since the last transfer */
+  void catchUp() {
+    uint32_t now = micros();
+    _mock->advance(now - _last);
+    _last = now;
+  }
+
+  Adafruit_FXOS8700_Mock *_mock;
+  uint32_t _last; ///< micros() at the last transfer
+};
+
+#endif
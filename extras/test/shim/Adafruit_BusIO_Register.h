@@ -0,0 +1,17 @@
+/*!
+ * @file Adafruit_BusIO_Register.h
+ *
+ * Stand-in for the Adafruit BusIO register helpers for the host build, see
+ * extras/test/Makefile. The library only includes it for the device
+ * classes.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __HOST_ADAFRUIT_BUSIO_REGISTER_H__
+#define __HOST_ADAFRUIT_BUSIO_REGISTER_H__
+
+#include <Adafruit_I2CDevice.h>
+#include <Adafruit_SPIDevice.h>
+
+#endif
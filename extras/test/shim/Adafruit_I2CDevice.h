@@ -0,0 +1,121 @@
+/*!
+ * @file Adafruit_I2CDevice.h
+ *
+ * Minimal Adafruit BusIO I2C device for the host build, see
+ * extras/test/Makefile. Transfers go to the HostI2CTarget attached to the
+ * bus at the device's address with TwoWire::attach(), and fail like a
+ * missing device if there is none.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __HOST_ADAFRUIT_I2CDEVICE_H__
+#define __HOST_ADAFRUIT_I2CDEVICE_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/*!
+    @brief  I2C device with the Adafruit BusIO interface, backed by a
+            simulated device on a TwoWire.
+*/
+class Adafruit_I2CDevice {
+public:
+  /*!
+      @brief  Instantiates a new I2C device.
+      @param  addr The 7-bit I2C address.
+      @param  theWire The I2C bus.
+  */
+  Adafruit_I2CDevice(uint8_t addr, TwoWire *theWire = &Wire)
+      : _addr(addr), _wire(theWire) {}
+
+  /*! @brief  Gets the device address. @return The 7-bit I2C address. */
+  uint8_t address(void) { return _addr; }
+
+  /*!
+      @brief  Looks for the device.
+      @param  addr_detect Set to true to check the address acknowledges.
+      @return True if a device is attached at the address, or addr_detect
+              is false.
+  */
+  bool begin(bool addr_detect = true) { return !addr_detect || detected(); }
+
+  /*!
+      @brief  Checks the address acknowledges, costing one address byte.
+      @return True if a device is attached at the address.
+  */
+  bool detected(void) {
+    _wire->transfer(1);
+    return _wire->find(_addr) != NULL;
+  }
+
+  /*!
+      @brief  Reads without setting a register first.
+      @return False, the simulated devices need a register address.
+  */
+  bool read(uint8_t *, size_t, bool = true) { return false; }
+
+  /*!
+      @brief  Writes to the device. The first byte, from prefix_buffer if
+              there is one, is the register address.
+      @param  buffer The bytes to write after the prefix.
+      @param  len The number of bytes in buffer.
+      @param  stop Unused, every transfer ends with a stop.
+      @param  prefix_buffer Bytes to write first, or NULL.
+      @param  prefix_len The number of bytes in prefix_buffer.
+      @return True if the device acknowledged.
+  */
+  bool write(const uint8_t *buffer, size_t len, bool stop = true,
+             const uint8_t *prefix_buffer = NULL, size_t prefix_len = 0) {
+    (void)stop;
+    _wire->transfer(1 + prefix_len + len);
+
+    HostI2CTarget *target = _wire->find(_addr);
+    if (!target)
+      return false;
+    if (prefix_len)
+      return target->write(prefix_buffer[0], buffer, len);
+    return len && target->write(buffer[0], buffer + 1, len - 1);
+  }
+
+  /*!
+      @brief  Writes the register address, then reads with a repeated
+              start.
+      @param  write_buffer The bytes to write, the register address first.
+      @param  write_len The number of bytes in write_buffer.
+      @param  read_buffer The buffer to read into.
+      @param  read_len The number of bytes to read.
+      @param  stop Unused, the repeated start is always sent.
+      @return True if the device acknowledged.
+  */
+  bool write_then_read(const uint8_t *write_buffer, size_t write_len,
+                       uint8_t *read_buffer, size_t read_len,
+                       bool stop = false) {
+    (void)stop;
+    _wire->transfer(1 + write_len + 1 + read_len);
+
+    HostI2CTarget *target = _wire->find(_addr);
+    if (!target || write_len == 0)
+      return false;
+    return target->read(write_buffer[0], read_buffer, read_len);
+  }
+
+  /*!
+      @brief  Sets the bus clock.
+      @param  desiredclk The clock in Hz.
+      @return True.
+  */
+  bool setSpeed(uint32_t desiredclk) {
+    _wire->setClock(desiredclk);
+    return true;
+  }
+
+  /*! @brief  Gets the largest transfer. @return 32 bytes, like AVR Wire. */
+  size_t maxBufferSize() { return 32; }
+
+private:
+  uint8_t _addr;
+  TwoWire *_wire;
+};
+
+#endif
@@ -0,0 +1,67 @@
+/*!
+ * @file Adafruit_SPIDevice.h
+ *
+ * Minimal Adafruit BusIO SPI device for the host build, see
+ * extras/test/Makefile. There is nothing on the bus, so every transfer
+ * fails.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __HOST_ADAFRUIT_SPIDEVICE_H__
+#define __HOST_ADAFRUIT_SPIDEVICE_H__
+
+#include <Arduino.h>
+#include <SPI.h>
+
+/*!
+    Bit order of an Adafruit_SPIDevice
+*/
+typedef enum {
+  SPI_BITORDER_MSBFIRST = MSBFIRST, /**< Most significant bit first */
+  SPI_BITORDER_LSBFIRST = LSBFIRST, /**< Least significant bit first */
+} BusIOBitOrder;
+
+/*!
+    @brief  SPI device with the Adafruit BusIO interface and no device
+            behind it.
+*/
+class Adafruit_SPIDevice {
+public:
+  /*!
+      @brief  Instantiates a new hardware SPI device.
+      @param  cspin The chip select pin.
+      @param  freq The SPI clock frequency.
+      @param  dataOrder The bit order.
+      @param  dataMode The SPI mode.
+      @param  theSPI The SPI bus.
+  */
+  Adafruit_SPIDevice(int8_t cspin, uint32_t freq = 1000000,
+                     BusIOBitOrder dataOrder = SPI_BITORDER_MSBFIRST,
+                     uint8_t dataMode = SPI_MODE0, SPIClass *theSPI = &SPI) {
+    (void)cspin;
+    (void)freq;
+    (void)dataOrder;
+    (void)dataMode;
+    (void)theSPI;
+  }
+
+  /*! @brief  Sets up the chip select pin. @return True. */
+  bool begin(void) { return true; }
+
+  /*! @brief  Reads from the device. @return False, the bus is empty. */
+  bool read(uint8_t *, size_t, uint8_t = 0xFF) { return false; }
+
+  /*! @brief  Writes to the device. @return False, the bus is empty. */
+  bool write(const uint8_t *, size_t, const uint8_t * = NULL, size_t = 0) {
+    return false;
+  }
+
+  /*! @brief  Writes then reads. @return False, the bus is empty. */
+  bool write_then_read(const uint8_t *, size_t, uint8_t *, size_t,
+                       uint8_t = 0xFF) {
+    return false;
+  }
+};
+
+#endif
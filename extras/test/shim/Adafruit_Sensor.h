@@ -0,0 +1,94 @@
+/*!
+ * @file Adafruit_Sensor.h
+ *
+ * The parts of the Adafruit Unified Sensor API the library uses, for the
+ * host build, see extras/test/Makefile. The types keep the layout of the
+ * real ones for the fields they have.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __HOST_ADAFRUIT_SENSOR_H__
+#define __HOST_ADAFRUIT_SENSOR_H__
+
+#include <Arduino.h>
+
+#define SENSORS_GRAVITY_STANDARD (9.80665F) ///< Earth's gravity in m/s^2
+
+/** Sensor types */
+typedef enum {
+  SENSOR_TYPE_ACCELEROMETER = (1),  /**< Gravity + linear acceleration */
+  SENSOR_TYPE_MAGNETIC_FIELD = (2), /**< Magnetic field */
+  SENSOR_TYPE_ORIENTATION = (3),    /**< Roll, pitch and heading */
+  SENSOR_TYPE_GYROSCOPE = (4),      /**< Angular rate */
+} sensors_type_t;
+
+/** Three axis data */
+typedef struct {
+  union {
+    float v[3]; ///< The axes as an array
+    struct {
+      float x; ///< X component
+      float y; ///< Y component
+      float z; ///< Z component
+    };
+    struct {
+      float roll;    ///< Rotation around the longitudinal axis
+      float pitch;   ///< Rotation around the lateral axis
+      float heading; ///< Angle between the longitudinal axis and north
+    };
+  };
+  int8_t status;       ///< Status byte
+  uint8_t reserved[3]; ///< Padding
+} sensors_vec_t;
+
+/** A sensor reading */
+typedef struct {
+  int32_t version;   ///< Must be sizeof(struct sensors_event_t)
+  int32_t sensor_id; ///< Unique sensor identifier
+  int32_t type;      ///< Sensor type
+  int32_t reserved0; ///< Reserved
+  int32_t timestamp; ///< Time in milliseconds
+  union {
+    float data[4];              ///< Raw data
+    sensors_vec_t acceleration; ///< Acceleration values are in m/s^2
+    sensors_vec_t magnetic;     ///< Magnetic vector values are in micro-Tesla
+    sensors_vec_t orientation;  ///< Orientation values are in degrees
+    sensors_vec_t gyro;         ///< Gyroscope values are in rad/s
+  };
+} sensors_event_t;
+
+/** A sensor's capabilities */
+typedef struct {
+  char name[12];     ///< Sensor name
+  int32_t version;   ///< Version of the hardware + driver
+  int32_t sensor_id; ///< Unique sensor identifier
+  int32_t type;      ///< This sensor's type
+  float max_value;   ///< Maximum value of this sensor's value in SI units
+  float min_value;   ///< Minimum value of this sensor's value in SI units
+  float resolution;  ///< Smallest difference between two values
+  int32_t min_delay; ///< Min delay in microseconds between events
+} sensor_t;
+
+/*!
+    @brief  Common interface of the Adafruit Unified Sensor drivers.
+*/
+class Adafruit_Sensor {
+public:
+  Adafruit_Sensor() {}
+  virtual ~Adafruit_Sensor() {}
+
+  /*! @brief  Enables or disables auto-ranging, if the sensor has it. */
+  virtual void enableAutoRange(bool) {}
+
+  /*!
+      @brief  Gets the latest sensor event.
+      @return True if the event was read.
+  */
+  virtual bool getEvent(sensors_event_t *) = 0;
+
+  /*! @brief  Gets the sensor_t data. */
+  virtual void getSensor(sensor_t *) = 0;
+};
+
+#endif
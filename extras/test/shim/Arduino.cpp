@@ -0,0 +1,136 @@
+/*!
+ * @file Arduino.cpp
+ *
+ * Definitions for the minimal Arduino core in Arduino.h, Wire.h and SPI.h.
+ * Print and Serial are in Print.cpp.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+
+TwoWire Wire;
+SPIClass SPI;
+
+/** Microseconds since the start of the test run */
+static uint64_t hostMicros = 0;
+
+/**************************************************************************/
+/*!
+    @brief  Gets the simulated time in milliseconds.
+    @return Milliseconds since the start of the test run.
+*/
+/**************************************************************************/
+unsigned long millis(void) { return hostMicros / 1000; }
+
+/**************************************************************************/
+/*!
+    @brief  Gets the simulated time in microseconds, wrapping at 32 bits
+            like the AVR core.
+    @return Microseconds since the start of the test run.
+*/
+/**************************************************************************/
+unsigned long micros(void) { return (uint32_t)hostMicros; }
+
+/**************************************************************************/
+/*!
+    @brief  Moves the simulated time on.
+    @param  ms The time to wait in milliseconds.
+*/
+/**************************************************************************/
+void delay(unsigned long ms) { hostMicros += (uint64_t)ms * 1000; }
+
+/**************************************************************************/
+/*!
+    @brief  Moves the simulated time on.
+    @param  us The time to wait in microseconds.
+*/
+/**************************************************************************/
+void delayMicroseconds(unsigned int us) { hostMicros += us; }
+
+/**************************************************************************/
+/*!
+    @brief  Moves the simulated time on, for tests that stand in for the
+            rest of a sketch's loop().
+    @param  us The time that passes in microseconds.
+*/
+/**************************************************************************/
+void hostAdvanceMicros(uint32_t us) { hostMicros += us; }
+
+/**************************************************************************/
+/*!
+    @brief  Attaches a simulated device to the bus, or detaches it.
+    @param  addr The 7-bit I2C address.
+    @param  target The device, or NULL to detach the one at addr.
+    @return True if the device was attached, false if the bus is full.
+*/
+/**************************************************************************/
+bool TwoWire::attach(uint8_t addr, HostI2CTarget *target) {
+  for (uint8_t i = 0; i < HOST_I2C_DEVICES; i++) {
+    if (_targets[i] && _addrs[i] == addr) {
+      _targets[i] = target;
+      return true;
+    }
+  }
+  if (!target)
+    return true;
+
+  for (uint8_t i = 0; i < HOST_I2C_DEVICES; i++) {
+    if (!_targets[i]) {
+      _addrs[i] = addr;
+      _targets[i] = target;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Finds the simulated device at an address.
+    @param  addr The 7-bit I2C address.
+    @return The device, or NULL if nothing acknowledges at addr.
+*/
+/**************************************************************************/
+HostI2CTarget *TwoWire::find(uint8_t addr) {
+  for (uint8_t i = 0; i < HOST_I2C_DEVICES; i++) {
+    if (_targets[i] && _addrs[i] == addr)
+      return _targets[i];
+  }
+  return NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Moves the host clock on by the time a transfer takes, 9 clocks
+            per byte including the acknowledge, rounded up to 1us.
+    @param  bytes The bytes on the wire, including the address bytes.
+*/
+/**************************************************************************/
+void TwoWire::transfer(size_t bytes) {
+  uint64_t bits = (uint64_t)bytes * 9;
+  hostMicros += (bits * 1000000 + _clock - 1) / _clock;
+}
+
+/*! @brief  Does nothing, there are no pins on the host. */
+void pinMode(uint8_t, uint8_t) {}
+
+/*! @brief  Reads a pin. @return HIGH, every pin idles high. */
+int digitalRead(uint8_t) { return HIGH; }
+
+/*! @brief  Maps a pin to its interrupt. @return The pin number. */
+int digitalPinToInterrupt(uint8_t pin) { return pin; }
+
+/*! @brief  Does nothing, there are no pins on the host. */
+void attachInterrupt(uint8_t, void (*)(void), int) {}
+
+/*! @brief  Does nothing, there are no pins on the host. */
+void detachInterrupt(uint8_t) {}
+
+/*! @brief  Does nothing, the tests are single threaded. */
+void noInterrupts(void) {}
+
+/*! @brief  Does nothing, the tests are single threaded. */
+void interrupts(void) {}
@@ -0,0 +1,56 @@
+/*!
+ * @file Arduino.h
+ *
+ * Minimal Arduino core for building the library on the host, see
+ * extras/test/Makefile. Time only moves when a test calls
+ * hostAdvanceMicros(), when the code under test calls delay() or
+ * delayMicroseconds(), or by the wire time of each I2C transfer, so timing
+ * is deterministic.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __HOST_ARDUINO_H__
+#define __HOST_ARDUINO_H__
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef bool boolean; ///< Arduino alias for bool
+typedef uint8_t byte; ///< Arduino alias for uint8_t
+
+#define LOW (0x0)          ///< digitalRead() low level
+#define HIGH (0x1)         ///< digitalRead() high level
+#define INPUT (0x0)        ///< pinMode() input
+#define OUTPUT (0x1)       ///< pinMode() output
+#define INPUT_PULLUP (0x2) ///< pinMode() input with pull-up
+#define CHANGE (1)         ///< attachInterrupt() on any edge
+#define FALLING (2)        ///< attachInterrupt() on a falling edge
+#define RISING (3)         ///< attachInterrupt() on a rising edge
+#define LSBFIRST (0)       ///< SPI bit order, least significant bit first
+#define MSBFIRST (1)       ///< SPI bit order, most significant bit first
+
+#define PI (3.1415926535897932384626433832795)           ///< Pi
+#define DEG_TO_RAD (0.017453292519943295769236907684886) ///< Degrees to rad
+#define RAD_TO_DEG (57.295779513082320876798154814105)   ///< Rad to degrees
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void hostAdvanceMicros(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*callback)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+void noInterrupts(void);
+void interrupts(void);
+
+#include "HardwareSerial.h"
+
+#endif
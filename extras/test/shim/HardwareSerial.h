@@ -0,0 +1,38 @@
+/*!
+ * @file HardwareSerial.h
+ *
+ * Minimal Arduino Serial for the host build, see extras/test/Makefile.
+ * Everything printed goes to stdout.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __HOST_HARDWARESERIAL_H__
+#define __HOST_HARDWARESERIAL_H__
+
+#include "Print.h"
+
+/*!
+    @brief  Serial port that writes to stdout and never has input.
+*/
+class HardwareSerial : public Print {
+public:
+  /*! @brief  Does nothing, stdout has no baud rate. */
+  void begin(unsigned long) {}
+  /*! @brief  Does nothing. */
+  void end() {}
+  /*! @brief  Checks for input. @return 0, there is never any. */
+  int available() { return 0; }
+  /*! @brief  Reads input. @return -1, there is never any. */
+  int read() { return -1; }
+  void flush();
+  size_t write(uint8_t c);
+  size_t write(const uint8_t *buffer, size_t size);
+  using Print::write;
+  /*! @brief  Checks the port is open. @return True, stdout always is. */
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial; ///< The serial port sketches print to
+
+#endif
@@ -0,0 +1,216 @@
+/*!
+ * @file Print.cpp
+ *
+ * Definitions for the minimal Print and HardwareSerial classes in Print.h
+ * and HardwareSerial.h.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#include "HardwareSerial.h"
+#include <stdio.h>
+#include <string.h>
+
+HardwareSerial Serial;
+
+/**************************************************************************/
+/*!
+    @brief  Writes a buffer one byte at a time.
+    @param  buffer The bytes to write.
+    @param  size The number of bytes.
+    @return The number of bytes written.
+*/
+/**************************************************************************/
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--)
+    n += write(*buffer++);
+  return n;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Prints an unsigned number in any base from 2 to 16.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+/**************************************************************************/
+size_t Print::printNumber(unsigned long n, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *str = &buf[sizeof(buf) - 1];
+
+  if (base < 2)
+    base = 10;
+
+  *str = '\0';
+  do {
+    unsigned long digit = n % base;
+    n /= base;
+    *--str = digit < 10 ? '0' + digit : 'A' + digit - 10;
+  } while (n);
+
+  return print(str);
+}
+
+/*! @brief  Prints a string. @param str The string. @return Bytes written. */
+size_t Print::print(const char *str) {
+  return write((const uint8_t *)str, strlen(str));
+}
+
+/*! @brief  Prints a character. @param c The character. @return 1. */
+size_t Print::print(char c) { return write((uint8_t)c); }
+
+/*!
+    @brief  Prints a number.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+size_t Print::print(unsigned char n, int base) {
+  return print((unsigned long)n, base);
+}
+
+/*!
+    @brief  Prints a number.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+size_t Print::print(int n, int base) { return print((long)n, base); }
+
+/*!
+    @brief  Prints a number.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+size_t Print::print(unsigned int n, int base) {
+  return print((unsigned long)n, base);
+}
+
+/*!
+    @brief  Prints a number, with a minus sign in base 10 only, like the
+            Arduino core.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+size_t Print::print(long n, int base) {
+  if (base == 10 && n < 0)
+    return print('-') + printNumber(0UL - (unsigned long)n, 10);
+  return printNumber((unsigned long)n, base);
+}
+
+/*!
+    @brief  Prints a number.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+size_t Print::print(unsigned long n, int base) { return printNumber(n, base); }
+
+/*!
+    @brief  Prints a number with a fixed number of decimals.
+    @param  n The number.
+    @param  digits The number of decimals.
+    @return The number of bytes written.
+*/
+size_t Print::print(double n, int digits) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return print(buf);
+}
+
+/*!
+    @brief  Ends a line, with a bare newline rather than the core's CR LF
+            so the output diffs cleanly.
+    @return The number of bytes written.
+*/
+size_t Print::println(void) { return print('\n'); }
+
+/*!
+    @brief  Prints a string and ends the line.
+    @param  str The string.
+    @return The number of bytes written.
+*/
+size_t Print::println(const char *str) { return print(str) + println(); }
+
+/*!
+    @brief  Prints a character and ends the line.
+    @param  c The character.
+    @return The number of bytes written.
+*/
+size_t Print::println(char c) { return print(c) + println(); }
+
+/*!
+    @brief  Prints a number and ends the line.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+size_t Print::println(unsigned char n, int base) {
+  return print(n, base) + println();
+}
+
+/*!
+    @brief  Prints a number and ends the line.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+size_t Print::println(int n, int base) { return print(n, base) + println(); }
+
+/*!
+    @brief  Prints a number and ends the line.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+size_t Print::println(unsigned int n, int base) {
+  return print(n, base) + println();
+}
+
+/*!
+    @brief  Prints a number and ends the line.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+size_t Print::println(long n, int base) { return print(n, base) + println(); }
+
+/*!
+    @brief  Prints a number and ends the line.
+    @param  n The number.
+    @param  base The base.
+    @return The number of bytes written.
+*/
+size_t Print::println(unsigned long n, int base) {
+  return print(n, base) + println();
+}
+
+/*!
+    @brief  Prints a number and ends the line.
+    @param  n The number.
+    @param  digits The number of decimals.
+    @return The number of bytes written.
+*/
+size_t Print::println(double n, int digits) {
+  return print(n, digits) + println();
+}
+
+/*! @brief  Flushes stdout. */
+void HardwareSerial::flush() { fflush(stdout); }
+
+/*! @brief  Writes one byte to stdout. @param c The byte. @return 1. */
+size_t HardwareSerial::write(uint8_t c) { return fwrite(&c, 1, 1, stdout); }
+
+/*!
+    @brief  Writes a buffer to stdout.
+    @param  buffer The bytes to write.
+    @param  size The number of bytes.
+    @return The number of bytes written.
+*/
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  return fwrite(buffer, 1, size, stdout);
+}
@@ -0,0 +1,59 @@
+/*!
+ * @file Print.h
+ *
+ * Minimal Arduino Print class for the host build, see extras/test/Makefile.
+ * Numbers are formatted the way the Arduino core formats them.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __HOST_PRINT_H__
+#define __HOST_PRINT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DEC (10) ///< print() in decimal
+#define HEX (16) ///< print() in hexadecimal
+#define OCT (8)  ///< print() in octal
+#define BIN (2)  ///< print() in binary
+
+/*!
+    @brief  Formats text and numbers and hands the bytes to write().
+*/
+class Print {
+public:
+  virtual ~Print() {}
+
+  /*!
+      @brief  Writes one byte.
+      @param  c The byte to write.
+      @return The number of bytes written.
+  */
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+
+  size_t print(const char *str);
+  size_t print(char c);
+  size_t print(unsigned char n, int base = DEC);
+  size_t print(int n, int base = DEC);
+  size_t print(unsigned int n, int base = DEC);
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int digits = 2);
+
+  size_t println(void);
+  size_t println(const char *str);
+  size_t println(char c);
+  size_t println(unsigned char n, int base = DEC);
+  size_t println(int n, int base = DEC);
+  size_t println(unsigned int n, int base = DEC);
+  size_t println(long n, int base = DEC);
+  size_t println(unsigned long n, int base = DEC);
+  size_t println(double n, int digits = 2);
+
+private:
+  size_t printNumber(unsigned long n, int base);
+};
+
+#endif
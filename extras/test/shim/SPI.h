@@ -0,0 +1,31 @@
+/*!
+ * @file SPI.h
+ *
+ * Minimal SPIClass for the host build, see extras/test/Makefile.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __HOST_SPI_H__
+#define __HOST_SPI_H__
+
+#include <Arduino.h>
+
+#define SPI_MODE0 (0x00) ///< CPOL 0, CPHA 0
+#define SPI_MODE1 (0x01) ///< CPOL 0, CPHA 1
+#define SPI_MODE2 (0x02) ///< CPOL 1, CPHA 0
+#define SPI_MODE3 (0x03) ///< CPOL 1, CPHA 1
+
+/*!
+    @brief  Stand-in for the Arduino SPI bus, Adafruit_SPIDevice doesn't use
+            it on the host.
+*/
+class SPIClass {
+public:
+  /*! @brief  Does nothing. */
+  void begin() {}
+};
+
+extern SPIClass SPI; ///< The default SPI bus
+
+#endif
@@ -0,0 +1,75 @@
+/*!
+ * @file Wire.h
+ *
+ * Minimal TwoWire for the host build, see extras/test/Makefile. Simulated
+ * devices are attached to the bus by address, and every transfer moves the
+ * host clock on by the time it would take on the wire at the bus clock.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#ifndef __HOST_WIRE_H__
+#define __HOST_WIRE_H__
+
+#include <Arduino.h>
+
+/** Number of devices a TwoWire can have attached */
+#define HOST_I2C_DEVICES (4)
+
+/*!
+    @brief  A simulated register-based device on a TwoWire bus.
+*/
+class HostI2CTarget {
+public:
+  virtual ~HostI2CTarget() {}
+
+  /*!
+      @brief  Reads registers, auto-incrementing from reg.
+      @param  reg The first register.
+      @param  buffer The buffer to read into.
+      @param  len The number of registers.
+      @return True if the device acknowledged.
+  */
+  virtual bool read(uint8_t reg, uint8_t *buffer, size_t len) = 0;
+
+  /*!
+      @brief  Writes registers, auto-incrementing from reg.
+      @param  reg The first register.
+      @param  buffer The values to write.
+      @param  len The number of registers.
+      @return True if the device acknowledged.
+  */
+  virtual bool write(uint8_t reg, const uint8_t *buffer, size_t len) = 0;
+};
+
+/*!
+    @brief  Stand-in for the Arduino I2C bus, holding the simulated devices
+            Adafruit_I2CDevice talks to.
+*/
+class TwoWire {
+public:
+  /*! @brief  Does nothing. */
+  void begin() {}
+
+  /*!
+      @brief  Sets the bus clock the transfer times are worked out from.
+      @param  clock The clock in Hz.
+  */
+  void setClock(uint32_t clock) { _clock = clock ? clock : 100000; }
+
+  /*! @brief  Gets the bus clock. @return The clock in Hz. */
+  uint32_t getClock() { return _clock; }
+
+  bool attach(uint8_t addr, HostI2CTarget *target);
+  HostI2CTarget *find(uint8_t addr);
+  void transfer(size_t bytes);
+
+private:
+  uint8_t _addrs[HOST_I2C_DEVICES];
+  HostI2CTarget *_targets[HOST_I2C_DEVICES] = {NULL};
+  uint32_t _clock = 100000;
+};
+
+extern TwoWire Wire; ///< The default I2C bus
+
+#endif
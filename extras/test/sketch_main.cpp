@@ -0,0 +1,68 @@
+/*!
+ * @file sketch_main.cpp
+ *
+ * Runs an example sketch on the host, see extras/test/Makefile. An
+ * Adafruit_FXOS8700_Mock replaying a slow turn about the Z axis sits on the
+ * default I2C bus at 0x1F, so sketches that call begin() find a sensor.
+ * setup() runs once, then loop() runs until the requested time has passed
+ * on the host clock.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#include "MockI2CTarget.h"
+#include <stdio.h>
+
+void setup(void);
+void loop(void);
+
+/** Simulated time loop() runs for, in ms, unless given on the command line */
+#define SKETCH_RUN_MS (3000)
+
+/** Host time each loop() takes on top of its own transfers and delays */
+#define SKETCH_LOOP_US (100)
+
+/** Samples in one turn, 20s of them at 200Hz */
+#define SKETCH_TRACE_LENGTH (4000)
+
+/**************************************************************************/
+/*!
+    @brief  Attaches the simulated sensor and runs the sketch.
+    @param  argc The number of arguments.
+    @param  argv The arguments, optionally the loop() run time in ms.
+    @return 0.
+*/
+/**************************************************************************/
+int main(int argc, char **argv) {
+  uint32_t runMs = (argc > 1) ? strtoul(argv[1], NULL, 10) : SKETCH_RUN_MS;
+
+  /* Lying nearly flat and turning slowly in a 44uT field dipping 60
+     degrees, with a count of noise so consecutive samples always differ */
+  static fxos8700Sample_t trace[SKETCH_TRACE_LENGTH];
+  for (uint16_t i = 0; i < SKETCH_TRACE_LENGTH; i++) {
+    float heading = i * (2 * PI / SKETCH_TRACE_LENGTH);
+    int16_t noise = (i & 1) ? 1 : -1;
+    trace[i].accel.x = 200 * sin(heading);
+    trace[i].accel.y = 200 * cos(heading);
+    trace[i].accel.z = 4096 + noise;
+    trace[i].mag.x = 220 * cos(heading);
+    trace[i].mag.y = 220 * sin(heading);
+    trace[i].mag.z = -381 + noise;
+  }
+
+  static Adafruit_FXOS8700_Mock sensor;
+  static MockI2CTarget target(&sensor);
+  sensor.setTrace(trace, SKETCH_TRACE_LENGTH);
+  Wire.attach(0x1F, &target);
+
+  setup();
+
+  uint32_t end = millis() + runMs;
+  while ((int32_t)(millis() - end) < 0) {
+    loop();
+    hostAdvanceMicros(SKETCH_LOOP_US);
+  }
+
+  Serial.flush();
+  return 0;
+}
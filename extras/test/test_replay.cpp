@@ -0,0 +1,875 @@
+/*!
+ * @file test_replay.cpp
+ *
+ * Host tests that replay samples through Adafruit_FXOS8700_Mock and check
+ * the decoded values and the bus transfers each read costs. Built and run
+ * by extras/test/Makefile, once with the float and once with the
+ * fixed-point fusion filter.
+ *
+ * MIT license, all text here must be included in any redistribution.
+ *
+ */
+#include "Adafruit_FXOS8700.h"
+#include "Adafruit_FXOS8700_Frame.h"
+#include "Adafruit_FXOS8700_Fusion.h"
+#include "Adafruit_FXOS8700_Group.h"
+#include "Adafruit_FXOS8700_Mock.h"
+#include "Adafruit_FXOS8700_Static.h"
+#include "MockI2CTarget.h"
+#include <stdio.h>
+
+/** Checks a condition, reporting it and carrying on if it doesn't hold */
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+/** Checks two floats are within a tolerance of each other */
+#define CHECK_NEAR(a, b, tol) CHECK(fabs((double)(a) - (double)(b)) <= (tol))
+
+/** I2C address begin() looks for the sensor at by default */
+#define MOCK_I2C_ADDRESS (0x1F)
+
+/** Number of failed checks */
+static int failures = 0;
+
+/**************************************************************************/
+/*!
+    @brief  Reports a failed check.
+    @param  ok The result of the check.
+    @param  expr The checked expression.
+    @param  line The line the check is on.
+*/
+/**************************************************************************/
+static void check(bool ok, const char *expr, int line) {
+  if (ok)
+    return;
+  printf("test_replay.cpp:%d: check failed: %s\n", line, expr);
+  failures++;
+}
+
+/*!
+    @brief  Mock that fails every write to one register, like a device
+            that stops acknowledging partway through a configuration.
+*/
+class FailingWriteMock : public Adafruit_FXOS8700_Mock {
+public:
+  int failRegister = -1; ///< Register whose writes fail, -1 for none
+
+  /*!
+      @brief  Writes registers, unless the write starts at failRegister.
+      @param  reg The first register.
+      @param  buffer The values to write.
+      @param  len The number of registers.
+      @return False for failRegister, otherwise the mock's result.
+  */
+  bool write(uint8_t reg, const uint8_t *buffer, size_t len) {
+    if (reg == failRegister)
+      return false;
+    return Adafruit_FXOS8700_Mock::write(reg, buffer, len);
+  }
+};
+
+/** The compile-time driver, which shares the rate tables */
+typedef Adafruit_FXOS8700_Static<HYBRID_MODE, ACCEL_RANGE_2G, ODR_100HZ>
+    StaticHybrid;
+static_assert(StaticHybrid::getOutputDataRateHz() == 100.0F,
+              "ODR_100HZ should give 100Hz in hybrid mode");
+
+/**************************************************************************/
+/*!
+    @brief  Replays a trace through readSample() and checks every sample
+            decodes to the recorded counts in one 13 byte burst.
+*/
+/**************************************************************************/
+static void testReplaySamples() {
+  /* Full scale both ways on every axis, and the values either side of
+     the byte boundaries */
+  const fxos8700Sample_t trace[] = {
+      {0, {0, 0, 4096}, {220, 0, -381}, 0},
+      {0, {8191, -8192, 1}, {32767, -32768, -1}, 0},
+      {0, {-8192, 8191, -1}, {-32768, 32767, 1}, 0},
+      {0, {255, 256, -256}, {255, 256, -256}, 0},
+      {0, {-4096, 2048, -2048}, {-220, 381, 0}, 0},
+  };
+  const size_t count = sizeof(trace) / sizeof(trace[0]);
+
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+  mock.setTrace(trace, count, false);
+
+  for (size_t i = 0; i < count; i++) {
+    CHECK(mock.tick());
+    mock.resetStats();
+
+    fxos8700Sample_t sample;
+    CHECK(accelmag.readSample(&sample));
+    CHECK(sample.accel.x == trace[i].accel.x);
+    CHECK(sample.accel.y == trace[i].accel.y);
+    CHECK(sample.accel.z == trace[i].accel.z);
+    CHECK(sample.mag.x == trace[i].mag.x);
+    CHECK(sample.mag.y == trace[i].mag.y);
+    CHECK(sample.mag.z == trace[i].mag.z);
+    CHECK(sample.status & 0x08);
+
+    /* STATUS, the accelerometer and, after the hybrid jump, the
+       magnetometer, in one transfer */
+    fxos8700MockStats_t stats;
+    mock.getStats(&stats);
+    CHECK(stats.reads == 1);
+    CHECK(stats.bytesRead == 13);
+    CHECK(stats.writes == 0);
+  }
+
+  /* Reading again before the next sample shows zyxdr cleared */
+  fxos8700Sample_t sample;
+  CHECK(accelmag.readSample(&sample));
+  CHECK(!(sample.status & 0x08));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks getEvent() converts to SI units in one burst, in every
+            mode.
+*/
+/**************************************************************************/
+static void testReplayEvents() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+
+  const fxos8700RawData_t accel = {0, -2048, 4096};
+  const fxos8700RawData_t mag = {220, 0, -381};
+  mock.setSample(accel, mag);
+  CHECK(mock.tick());
+  mock.resetStats();
+
+  sensors_event_t accelEvent, magEvent;
+  CHECK(accelmag.getEvent(&accelEvent, &magEvent));
+  CHECK(accelEvent.sensor_id == 1);
+  CHECK(accelEvent.type == SENSOR_TYPE_ACCELEROMETER);
+  CHECK_NEAR(accelEvent.acceleration.x, 0, 1e-6);
+  CHECK_NEAR(accelEvent.acceleration.y, -2048 * ACCEL_MG_LSB_2G * 9.80665,
+             1e-4);
+  CHECK_NEAR(accelEvent.acceleration.z, 4096 * ACCEL_MG_LSB_2G * 9.80665,
+             1e-4);
+  CHECK(magEvent.sensor_id == 2);
+  CHECK(magEvent.type == SENSOR_TYPE_MAGNETIC_FIELD);
+  CHECK_NEAR(magEvent.magnetic.x, 22.0, 1e-4);
+  CHECK_NEAR(magEvent.magnetic.z, -38.1, 1e-4);
+
+  fxos8700MockStats_t stats;
+  mock.getStats(&stats);
+  CHECK(stats.reads == 1);
+  CHECK(stats.bytesRead == 13);
+
+  /* The scale follows the range */
+  CHECK(accelmag.setAccelRange(ACCEL_RANGE_8G) == FXOS8700_OK);
+  CHECK(mock.tick());
+  CHECK(accelmag.getEvent(&accelEvent, &magEvent));
+  CHECK_NEAR(accelEvent.acceleration.z, 4096 * ACCEL_MG_LSB_8G * 9.80665,
+             1e-4);
+
+  /* A single sensor mode reads STATUS and one sensor's output */
+  CHECK(accelmag.setSensorMode(ACCEL_ONLY_MODE) == FXOS8700_OK);
+  CHECK(mock.tick());
+  mock.resetStats();
+  CHECK(accelmag.getEvent(&accelEvent));
+  CHECK(accelEvent.type == SENSOR_TYPE_ACCELEROMETER);
+  mock.getStats(&stats);
+  CHECK(stats.reads == 1);
+  CHECK(stats.bytesRead == 7);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks the split Adafruit_Sensor objects share one burst per
+            sample period.
+*/
+/**************************************************************************/
+static void testSplitSensors() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+  CHECK(mock.tick());
+  mock.resetStats();
+
+  Adafruit_Sensor *accel = accelmag.getAccelerometerSensor();
+  Adafruit_Sensor *mag = accelmag.getMagnetometerSensor();
+  sensors_event_t accelEvent, magEvent;
+  fxos8700MockStats_t stats;
+
+  CHECK(accel->getEvent(&accelEvent));
+  CHECK(mag->getEvent(&magEvent));
+  CHECK(accelEvent.timestamp == magEvent.timestamp);
+  mock.getStats(&stats);
+  CHECK(stats.reads == 1);
+
+  /* 100Hz hybrid uses the 200Hz dr[2:0] bits, 10ms per sample */
+  hostAdvanceMicros(5000);
+  CHECK(accel->getEvent(&accelEvent));
+  mock.getStats(&stats);
+  CHECK(stats.reads == 1);
+
+  hostAdvanceMicros(5000);
+  CHECK(accel->getEvent(&accelEvent));
+  mock.getStats(&stats);
+  CHECK(stats.reads == 2);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks a failed setter leaves the driver and sensor as they
+            were, and that automatic recovery waits for the next read.
+*/
+/**************************************************************************/
+static void testBusErrors() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  FailingWriteMock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+
+  const fxos8700RetryPolicy_t policy = {1, 0, 1};
+  accelmag.setRetryPolicy(policy);
+
+  mock.failRegister = FXOS8700_REGISTER_XYZ_DATA_CFG;
+  CHECK(accelmag.setAccelRange(ACCEL_RANGE_4G) == FXOS8700_BUS_ERROR);
+  CHECK(accelmag.getAccelRange() == ACCEL_RANGE_2G);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_XYZ_DATA_CFG) & 0x03) == 0);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_CTRL_REG1) & 0x01);
+
+  /* The failed write reached recoverAfter, the next read recovers first */
+  mock.failRegister = -1;
+  CHECK(mock.tick());
+  mock.resetStats();
+  fxos8700Sample_t sample;
+  CHECK(accelmag.readSample(&sample));
+  fxos8700MockStats_t stats;
+  mock.getStats(&stats);
+  CHECK(stats.writes > 0);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_CTRL_REG1) & 0x01);
+
+  /* And only once */
+  CHECK(mock.tick());
+  mock.resetStats();
+  CHECK(accelmag.readSample(&sample));
+  mock.getStats(&stats);
+  CHECK(stats.writes == 0);
+
+  /* A read that fails outright reports it */
+  mock.failTransfers(1);
+  CHECK(!accelmag.readSample(&sample));
+  CHECK(accelmag.getLastError() == FXOS8700_BUS_ERROR);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks the mode and output data rate stay consistent.
+*/
+/**************************************************************************/
+static void testModeAndRate() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+  CHECK(accelmag.getOutputDataRateHz() == 100.0F);
+
+  /* Leaving hybrid mode keeps the rate */
+  CHECK(accelmag.setSensorMode(ACCEL_ONLY_MODE) == FXOS8700_OK);
+  CHECK(accelmag.getOutputDataRate() == ODR_100HZ);
+  CHECK(accelmag.getOutputDataRateHz() == 100.0F);
+  CHECK(mock.getSamplePeriod() == 10000);
+
+  /* 800Hz doesn't exist in hybrid mode */
+  CHECK(accelmag.setOutputDataRate(ODR_800HZ) == FXOS8700_OK);
+  CHECK(accelmag.setSensorMode(HYBRID_MODE) == FXOS8700_UNSUPPORTED);
+  CHECK(accelmag.getSensorMode() == ACCEL_ONLY_MODE);
+  CHECK(accelmag.getOutputDataRateHz() == 800.0F);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks getSensor() reports the 14-bit two's complement range.
+*/
+/**************************************************************************/
+static void testSensorLimits() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+
+  sensor_t accel, mag;
+  accelmag.getSensor(&accel, &mag);
+  CHECK_NEAR(accel.min_value, -8192 * ACCEL_MG_LSB_2G * 9.80665, 1e-4);
+  CHECK_NEAR(accel.max_value, 8191 * ACCEL_MG_LSB_2G * 9.80665, 1e-4);
+  CHECK(accel.max_value < -accel.min_value);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks an automatic group period follows the sensors' rates.
+*/
+/**************************************************************************/
+static void testGroupPeriod() {
+  Adafruit_FXOS8700 first(1, 2), second(3, 4);
+  Adafruit_FXOS8700_Mock firstMock, secondMock;
+  CHECK(first.begin_Transport(&firstMock));
+  CHECK(second.begin_Transport(&secondMock));
+
+  Adafruit_FXOS8700_Group group;
+  CHECK(group.add(&first));
+  CHECK(group.add(&second));
+  CHECK(group.isAutoPeriod());
+
+  group.begin();
+  CHECK(group.getPeriod() == 10000);
+
+  /* begin() picks the period again from the slowest sensor */
+  CHECK(second.setOutputDataRate(ODR_50HZ) == FXOS8700_OK);
+  group.begin();
+  CHECK(group.getPeriod() == 20000);
+  CHECK(group.isAutoPeriod());
+
+  group.setPeriod(5000);
+  group.begin();
+  CHECK(group.getPeriod() == 5000);
+  CHECK(!group.isAutoPeriod());
+
+  group.setPeriod(0);
+  group.begin();
+  CHECK(group.getPeriod() == 20000);
+  CHECK(group.isAutoPeriod());
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks readFifo() drains the FIFO oldest first in one burst,
+            and what each FIFO mode keeps once it is full.
+*/
+/**************************************************************************/
+static void testFifo() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+
+  /* Every sample tells its place in the trace by accel.x */
+  fxos8700Sample_t trace[48];
+  for (int16_t i = 0; i < 48; i++) {
+    trace[i] = fxos8700Sample_t();
+    trace[i].accel.x = i;
+    trace[i].accel.z = 4096;
+  }
+  fxos8700RawData_t out[FXOS8700_FIFO_SIZE];
+  fxos8700MockStats_t stats;
+
+  /* Disabled, there's nothing to count or read */
+  CHECK(accelmag.getFifoCount() == 0);
+  CHECK(accelmag.readFifo(out, FXOS8700_FIFO_SIZE) == 0);
+
+  CHECK(accelmag.setFifoMode(FIFO_MODE_CIRCULAR) == FXOS8700_OK);
+  CHECK(accelmag.getFifoMode() == FIFO_MODE_CIRCULAR);
+  mock.setTrace(trace, 48, false);
+  for (uint8_t i = 0; i < 10; i++)
+    CHECK(mock.tick());
+  CHECK(accelmag.getFifoCount() == 10);
+
+  /* A partial read leaves the rest in place, F_STATUS then the samples */
+  mock.resetStats();
+  CHECK(accelmag.readFifo(out, 4) == 4);
+  for (int16_t i = 0; i < 4; i++)
+    CHECK(out[i].x == i);
+  CHECK(out[0].z == 4096);
+  mock.getStats(&stats);
+  CHECK(stats.reads == 2);
+  CHECK(stats.bytesRead == 1 + 4 * 6);
+
+  CHECK(accelmag.getFifoCount() == 6);
+  CHECK(accelmag.readFifo(out, FXOS8700_FIFO_SIZE) == 6);
+  for (int16_t i = 0; i < 6; i++)
+    CHECK(out[i].x == 4 + i);
+  CHECK(accelmag.readFifo(out, FXOS8700_FIFO_SIZE) == 0);
+
+  /* Circular mode overwrites the oldest samples and flags the overflow */
+  for (uint8_t i = 0; i < FXOS8700_FIFO_SIZE + 2; i++)
+    CHECK(mock.tick());
+  uint8_t fstatus;
+  CHECK(mock.read(FXOS8700_REGISTER_STATUS, &fstatus, 1));
+  CHECK(fstatus & 0x80);
+  CHECK((fstatus & 0x3F) == FXOS8700_FIFO_SIZE);
+  CHECK(accelmag.readFifo(out, FXOS8700_FIFO_SIZE) == FXOS8700_FIFO_SIZE);
+  CHECK(out[0].x == 12);
+  CHECK(out[FXOS8700_FIFO_SIZE - 1].x == 43);
+
+  /* Stop mode keeps the oldest samples and drops the rest */
+  CHECK(accelmag.setFifoMode(FIFO_MODE_STOP) == FXOS8700_OK);
+  mock.setTrace(trace, 48, false);
+  for (uint8_t i = 0; i < FXOS8700_FIFO_SIZE + 4; i++)
+    CHECK(mock.tick());
+  CHECK(mock.read(FXOS8700_REGISTER_STATUS, &fstatus, 1));
+  CHECK(fstatus & 0x80);
+  CHECK((fstatus & 0x3F) == FXOS8700_FIFO_SIZE);
+  CHECK(accelmag.readFifo(out, FXOS8700_FIFO_SIZE) == FXOS8700_FIFO_SIZE);
+  CHECK(out[0].x == 0);
+  CHECK(out[FXOS8700_FIFO_SIZE - 1].x == FXOS8700_FIFO_SIZE - 1);
+
+  /* A failed F_STATUS read reads nothing and reports it */
+  CHECK(mock.tick());
+  mock.failTransfers(1);
+  CHECK(accelmag.readFifo(out, FXOS8700_FIFO_SIZE) == 0);
+  CHECK(accelmag.getLastError() == FXOS8700_BUS_ERROR);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Encodes samples into a frame and checks they decode back to
+            the same counts, timestamps and overrun flags.
+*/
+/**************************************************************************/
+static void testFrameRoundTrip() {
+  /* The first delta is always 0, then one, two and three delta groups */
+  const fxos8700Sample_t samples[] = {
+      {1000, {8191, -8192, 1}, {32767, -32768, -1}, 0x08},
+      {1100, {-8192, 8191, -1}, {-32768, 32767, 1}, 0x08},
+      {11100, {255, 256, -256}, {255, 256, -256}, 0x88},
+      {311100, {0, 0, 4096}, {220, 0, -381}, 0x08},
+  };
+  const size_t count = sizeof(samples) / sizeof(samples[0]);
+
+  uint8_t frame[64];
+  Adafruit_FXOS8700_FrameEncoder encoder;
+  CHECK(encoder.begin(frame, sizeof(frame), FXOS8700_DEFAULT_CONFIG));
+  for (size_t i = 0; i < count; i++)
+    CHECK(encoder.add(samples[i]));
+  CHECK(encoder.getCount() == count);
+
+  /* 1 + 8 per delta group + 3 x 14 + 3 x 16 bits per sample */
+  size_t length = encoder.finish();
+  CHECK(length == FXOS8700_FRAME_HEADER_SIZE + (4 * 91 + 8 * 7 + 7) / 8);
+
+  Adafruit_FXOS8700_FrameDecoder decoder;
+  CHECK(decoder.begin(frame, length));
+  CHECK(decoder.getSensorMode() == HYBRID_MODE);
+  CHECK(decoder.getAccelRange() == ACCEL_RANGE_2G);
+  CHECK(decoder.getOutputDataRate() == ODR_100HZ);
+  CHECK(decoder.getCount() == count);
+
+  fxos8700Sample_t sample;
+  for (size_t i = 0; i < count; i++) {
+    CHECK(decoder.next(&sample));
+    CHECK(sample.timestamp == samples[i].timestamp);
+    CHECK(sample.accel.x == samples[i].accel.x);
+    CHECK(sample.accel.y == samples[i].accel.y);
+    CHECK(sample.accel.z == samples[i].accel.z);
+    CHECK(sample.mag.x == samples[i].mag.x);
+    CHECK(sample.mag.y == samples[i].mag.y);
+    CHECK(sample.mag.z == samples[i].mag.z);
+    CHECK(sample.status == (samples[i].status & 0x80));
+  }
+  CHECK(!decoder.next(&sample));
+
+  /* A truncated frame stops at the last whole sample */
+  CHECK(decoder.begin(frame, length - 2));
+  for (size_t i = 0; i < count - 1; i++)
+    CHECK(decoder.next(&sample));
+  CHECK(!decoder.next(&sample));
+
+  /* An accel-only frame from a raw burst, 51 bits with room for one */
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+  CHECK(accelmag.setSensorMode(ACCEL_ONLY_MODE) == FXOS8700_OK);
+  const fxos8700RawData_t accel = {-1, 2048, -8192};
+  const fxos8700RawData_t mag = {1, 2, 3};
+  mock.setSample(accel, mag);
+  CHECK(mock.tick());
+
+  fxos8700Config_t config;
+  accelmag.getConfig(&config);
+  uint8_t burst[7];
+  CHECK(mock.read(FXOS8700_REGISTER_STATUS, burst, sizeof(burst)));
+  CHECK(encoder.begin(frame, FXOS8700_FRAME_HEADER_SIZE + 7, config));
+  CHECK(encoder.addBurst(burst, 5000));
+  CHECK(!encoder.addBurst(burst, 6000));
+  length = encoder.finish();
+
+  CHECK(decoder.begin(frame, length));
+  CHECK(decoder.getSensorMode() == ACCEL_ONLY_MODE);
+  CHECK(decoder.getCount() == 1);
+  CHECK(decoder.next(&sample));
+  CHECK(sample.timestamp == 5000);
+  CHECK(sample.accel.x == accel.x);
+  CHECK(sample.accel.y == accel.y);
+  CHECK(sample.accel.z == accel.z);
+  CHECK(sample.mag.x == 0);
+  CHECK(!decoder.next(&sample));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks readEvents() only reads the source registers of flagged
+            functions.
+*/
+/**************************************************************************/
+static void testReadEvents() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+
+  mock.setRegister(FXOS8700_REGISTER_INT_SOURCE,
+                   INT_SOURCE_PULSE | INT_SOURCE_ASLP);
+  mock.setRegister(FXOS8700_REGISTER_M_INT_SRC, MAG_INT_SOURCE_THS);
+  mock.setRegister(FXOS8700_REGISTER_PULSE_SRC, 0x08);
+  mock.setRegister(FXOS8700_REGISTER_M_THS_SRC, 0x81);
+  mock.setRegister(FXOS8700_REGISTER_TRANSIENT_SRC, 0x42);
+  mock.resetStats();
+
+  fxos8700Events_t events;
+  CHECK(accelmag.readEvents(&events));
+  CHECK(events.sources == (INT_SOURCE_PULSE | INT_SOURCE_ASLP));
+  CHECK(events.magSources == MAG_INT_SOURCE_THS);
+  CHECK(events.tap == 0x08);
+  CHECK(events.systemMode == WAKE);
+  CHECK(events.magThreshold == 0x81);
+
+  /* The transient function isn't flagged, so TRANSIENT_SRC stays unread */
+  CHECK(events.transient == 0);
+  CHECK(events.freefallMotion == 0);
+  fxos8700MockStats_t stats;
+  mock.getStats(&stats);
+  CHECK(stats.reads == 5);
+
+  mock.failTransfers(1);
+  CHECK(!accelmag.readEvents(&events));
+  CHECK(events.sources == 0);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks the registers auto-sleep and adaptive rate set, and that
+            disabling them puts back what was there before.
+*/
+/**************************************************************************/
+static void testAutoSleep() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+  CHECK(accelmag.enableDataReadyInterrupt(true) == FXOS8700_OK);
+  fxos8700MockStats_t stats;
+
+  /* 100Hz isn't one of the auto-sleep rates, nothing is written */
+  const fxos8700AutoSleepConfig_t fast = {ODR_100HZ, MAG_OSR_0,
+                                          ACCEL_OSM_LOW_POWER,
+                                          WAKE_SOURCE_TRANSIENT, 1000};
+  mock.resetStats();
+  CHECK(!accelmag.enableAutoSleep(fast));
+  mock.getStats(&stats);
+  CHECK(stats.writes == 0);
+
+  /* 6.25Hz hybrid is dr[2:0] = 5, the second aslp_rate[1:0] setting */
+  const fxos8700AutoSleepConfig_t config = {
+      ODR_6_25HZ, MAG_OSR_3, ACCEL_OSM_HIGH_RESOLUTION,
+      WAKE_SOURCE_TRANSIENT | WAKE_SOURCE_PULSE, 1000};
+  mock.resetStats();
+  CHECK(accelmag.enableAutoSleep(config));
+  CHECK(mock.getRegister(FXOS8700_REGISTER_ASLP_COUNT) == 4);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_CTRL_REG1) & 0xC1) == 0x41);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_CTRL_REG2) & 0x1C) == 0x14);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_CTRL_REG3) & 0x78) == 0x50);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_CTRL_REG4) == 0x29);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_MCTRL_REG3) & 0x70) == 0x30);
+  mock.getStats(&stats);
+  CHECK(stats.activeWrites == 0);
+
+  /* Only the interrupt enables auto-sleep turned on are cleared */
+  CHECK(accelmag.disableAutoSleep() == FXOS8700_OK);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_CTRL_REG2) & 0x1C) == 0);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_CTRL_REG3) & 0x78) == 0);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_CTRL_REG4) == 0x01);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_CTRL_REG1) & 0x01);
+
+  /* Adaptive rate, woken by 126mg (2 steps) for 2 samples, asleep after
+     5000ms (16 steps, rounded up) */
+  mock.resetStats();
+  CHECK(accelmag.enableAdaptiveRate());
+  CHECK(mock.getRegister(FXOS8700_REGISTER_TRANSIENT_CFG) == 0x0E);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_TRANSIENT_THS) == 0x82);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_TRANSIENT_COUNT) == 2);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_ASLP_COUNT) == 16);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_CTRL_REG1) & 0xC1) == 0x41);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_CTRL_REG2) & 0x1C) == 0x1C);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_CTRL_REG3) & 0x78) == 0x40);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_CTRL_REG4) == 0x21);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_MCTRL_REG3) & 0x70) == 0x00);
+  mock.getStats(&stats);
+  CHECK(stats.activeWrites == 0);
+
+  CHECK(accelmag.disableAdaptiveRate() == FXOS8700_OK);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_TRANSIENT_CFG) == 0x00);
+  CHECK((mock.getRegister(FXOS8700_REGISTER_CTRL_REG2) & 0x1C) == 0);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_CTRL_REG4) == 0x01);
+}
+
+/*!
+    @brief  Fake non-blocking transport that finishes a transfer on the
+            given poll, reading the mock then, like a DMA completing.
+*/
+struct FakeAsync {
+  Adafruit_FXOS8700_Mock *mock; ///< The device the transfers read
+  bool accept;                  ///< Whether startRead() starts a transfer
+  uint8_t pollsLeft;            ///< Polls before the transfer finishes
+  fxos8700Status_t result;      ///< Status the transfer finishes with
+  uint8_t addr;                 ///< Address of the last transfer
+  uint8_t reg;                  ///< First register of the last transfer
+  uint8_t *buffer;              ///< Buffer of the last transfer
+  size_t len;                   ///< Length of the last transfer
+  uint8_t starts;               ///< Transfers started
+};
+
+/*!
+    @brief  fxos8700AsyncTransport_t::startRead for FakeAsync.
+    @param  context The FakeAsync.
+    @param  addr The I2C address.
+    @param  reg The first register.
+    @param  buffer The buffer to read into.
+    @param  len The number of bytes.
+    @return FakeAsync::accept.
+*/
+static bool fakeStartRead(void *context, uint8_t addr, uint8_t reg,
+                          uint8_t *buffer, size_t len) {
+  FakeAsync *fake = (FakeAsync *)context;
+  fake->addr = addr;
+  fake->reg = reg;
+  fake->buffer = buffer;
+  fake->len = len;
+  if (fake->accept)
+    fake->starts++;
+  return fake->accept;
+}
+
+/*!
+    @brief  fxos8700AsyncTransport_t::poll for FakeAsync.
+    @param  context The FakeAsync.
+    @return FXOS8700_PENDING until the last poll, then FakeAsync::result.
+*/
+static fxos8700Status_t fakePoll(void *context) {
+  FakeAsync *fake = (FakeAsync *)context;
+  if (fake->pollsLeft > 0 && --fake->pollsLeft > 0)
+    return FXOS8700_PENDING;
+  if (fake->result == FXOS8700_OK &&
+      !fake->mock->read(fake->reg, fake->buffer, fake->len))
+    return FXOS8700_BUS_ERROR;
+  return fake->result;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks startRead()/finishRead() through async transport hooks,
+            over the host I2C bus since the hooks address an I2C device.
+*/
+/**************************************************************************/
+static void testAsyncRead() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  MockI2CTarget target(&mock);
+  CHECK(Wire.attach(MOCK_I2C_ADDRESS, &target));
+  CHECK(accelmag.begin());
+
+  const fxos8700RawData_t accel = {0, -2048, 4096};
+  const fxos8700RawData_t mag = {220, 0, -381};
+  mock.setSample(accel, mag);
+  CHECK(mock.tick());
+
+  FakeAsync fake = {&mock, true, 3, FXOS8700_OK, 0, 0, NULL, 0, 0};
+  const fxos8700AsyncTransport_t hooks = {fakeStartRead, fakePoll, &fake};
+  CHECK(accelmag.setAsyncTransport(&hooks));
+
+  /* One hybrid burst from STATUS, not read until the transfer is done */
+  sensors_event_t accelEvent, magEvent;
+  CHECK(accelmag.startRead());
+  CHECK(fake.addr == MOCK_I2C_ADDRESS);
+  CHECK(fake.reg == FXOS8700_REGISTER_STATUS);
+  CHECK(fake.len == 13);
+  CHECK(!accelmag.isReadComplete());
+  CHECK(!accelmag.finishRead(&accelEvent, &magEvent));
+
+  /* Neither a second transfer nor new hooks while this one is pending */
+  CHECK(!accelmag.startRead());
+  CHECK(fake.starts == 1);
+  CHECK(!accelmag.setAsyncTransport(NULL));
+
+  CHECK(accelmag.isReadComplete());
+  CHECK(accelmag.finishRead(&accelEvent, &magEvent));
+  CHECK_NEAR(accelEvent.acceleration.y, -2048 * ACCEL_MG_LSB_2G * 9.80665,
+             1e-4);
+  CHECK_NEAR(magEvent.magnetic.x, 22.0, 1e-4);
+  CHECK(accelmag.accel_raw.z == 4096);
+
+  /* A finished burst is only decoded once */
+  CHECK(!accelmag.finishRead(&accelEvent, &magEvent));
+
+  /* A transfer that fails, or doesn't start, has nothing to collect */
+  fake.pollsLeft = 1;
+  fake.result = FXOS8700_BUS_ERROR;
+  CHECK(accelmag.startRead());
+  CHECK(accelmag.isReadComplete());
+  CHECK(!accelmag.finishRead(&accelEvent, &magEvent));
+  fake.accept = false;
+  CHECK(!accelmag.startRead());
+  CHECK(!accelmag.finishRead(&accelEvent, &magEvent));
+
+  /* Without hooks the read is done inside startRead() */
+  CHECK(accelmag.setAsyncTransport(NULL));
+  CHECK(mock.tick());
+  CHECK(accelmag.startRead());
+  CHECK(accelmag.isReadComplete());
+  CHECK(accelmag.finishRead(&accelEvent, &magEvent));
+  CHECK_NEAR(magEvent.magnetic.z, -38.1, 1e-4);
+
+  Wire.attach(MOCK_I2C_ADDRESS, NULL);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks the magnetometer min/max controls land in MCTRL_REG2 and
+            report bus errors.
+*/
+/**************************************************************************/
+static void testMagMinMax() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+
+  /* m_maxmin_dis and m_maxmin_rst in MCTRL_REG2 */
+  CHECK(accelmag.enableMagMinMax(false) == FXOS8700_OK);
+  CHECK(mock.getRegister(FXOS8700_REGISTER_MCTRL_REG2) & 0x10);
+  CHECK(accelmag.enableMagMinMax(true) == FXOS8700_OK);
+  CHECK(!(mock.getRegister(FXOS8700_REGISTER_MCTRL_REG2) & 0x10));
+  CHECK(accelmag.resetMagMinMax() == FXOS8700_OK);
+
+  mock.failTransfers(1);
+  CHECK(accelmag.enableMagMinMax(false) == FXOS8700_BUS_ERROR);
+  mock.failTransfers(1);
+  CHECK(accelmag.resetMagMinMax() == FXOS8700_BUS_ERROR);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks getEvent() leaves the events of a disabled sensor alone
+            and doesn't touch the bus for them.
+*/
+/**************************************************************************/
+static void testDisabledSensorEvents() {
+  Adafruit_FXOS8700 accelmag(1, 2);
+  Adafruit_FXOS8700_Mock mock;
+  CHECK(accelmag.begin_Transport(&mock));
+  CHECK(accelmag.setSensorMode(MAG_ONLY_MODE) == FXOS8700_OK);
+  CHECK(mock.tick());
+  mock.resetStats();
+
+  sensors_event_t accelEvent, magEvent;
+  fxos8700MockStats_t stats;
+  accelEvent.sensor_id = -1;
+  CHECK(!accelmag.getEvent(&accelEvent, NULL));
+  CHECK(!accelmag.getAccelerometerSensor()->getEvent(&accelEvent));
+  mock.getStats(&stats);
+  CHECK(stats.reads == 0);
+
+  /* The mag event is filled from M_DR_STATUS and the mag outputs */
+  CHECK(accelmag.getEvent(&accelEvent, &magEvent));
+  CHECK(accelEvent.sensor_id == -1);
+  CHECK(magEvent.type == SENSOR_TYPE_MAGNETIC_FIELD);
+  mock.getStats(&stats);
+  CHECK(stats.reads == 1);
+  CHECK(stats.bytesRead == 7);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Converts a fusion angle to degrees.
+    @param  angle The angle, scaled by FXOS8700_FUSION_SCALE.
+    @return The angle in degrees.
+*/
+/**************************************************************************/
+static float degrees(fxos8700FusionReal_t angle) {
+  return (float)angle / FXOS8700_FUSION_SCALE;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks the eCompass angles, and that the filter starts from them
+            and follows a turn, in whichever arithmetic the build uses.
+*/
+/**************************************************************************/
+static void testFusion() {
+  /* Flat, tilted 30 degrees about x, and turned to a heading of 90 */
+  const fxos8700RawData_t flat = {0, 0, 4096};
+  const fxos8700RawData_t tilted = {0, 2048, 3547};
+  const fxos8700RawData_t north = {220, 0, -381};
+  const fxos8700RawData_t east = {0, 220, -381};
+  fxos8700Orientation_t orientation;
+
+  CHECK(Adafruit_FXOS8700_Fusion::compass(flat, north, &orientation));
+  CHECK_NEAR(degrees(orientation.roll), 0, 0.2);
+  CHECK_NEAR(degrees(orientation.pitch), 0, 0.2);
+  CHECK_NEAR(degrees(orientation.heading), 0, 0.2);
+
+  CHECK(Adafruit_FXOS8700_Fusion::compass(tilted, north, &orientation));
+  CHECK_NEAR(degrees(orientation.roll), 30, 0.2);
+  CHECK_NEAR(degrees(orientation.pitch), 0, 0.2);
+
+  CHECK(Adafruit_FXOS8700_Fusion::compass(flat, east, &orientation));
+  CHECK_NEAR(degrees(orientation.heading), 90, 0.2);
+
+  /* Readings with no direction are refused */
+  const fxos8700RawData_t zero = {0, 0, 0};
+  CHECK(!Adafruit_FXOS8700_Fusion::compass(zero, north, &orientation));
+  CHECK(!Adafruit_FXOS8700_Fusion::compass(flat, zero, &orientation));
+
+  /* The first update seeds the filter with the eCompass orientation */
+  fxos8700Orientation_t expected;
+  CHECK(Adafruit_FXOS8700_Fusion::compass(tilted, north, &expected));
+  Adafruit_FXOS8700_Fusion fusion;
+  fusion.begin(100);
+  CHECK(fusion.update(tilted, north));
+  fusion.getOrientation(&orientation);
+  CHECK_NEAR(degrees(orientation.roll), degrees(expected.roll), 0.2);
+  CHECK_NEAR(degrees(orientation.heading), degrees(expected.heading), 0.2);
+
+  /* Without a gyro it takes a while to settle on a new reading, heading
+     most of all in a field this steep, so give it a minute at 100Hz */
+  fusion.reset();
+  CHECK(fusion.update(flat, north));
+  for (uint16_t i = 0; i < 6000; i++)
+    CHECK(fusion.update(flat, east));
+  fusion.getOrientation(&orientation);
+  CHECK_NEAR(degrees(orientation.roll), 0, 0.5);
+  CHECK_NEAR(degrees(orientation.pitch), 0, 0.5);
+  CHECK_NEAR(degrees(fusion.getHeading()), 90, 0.5);
+  CHECK(!fusion.update(zero, east));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Runs every test.
+    @return 0 if every check passed, otherwise 1.
+*/
+/**************************************************************************/
+int main() {
+  testReplaySamples();
+  testReplayEvents();
+  testSplitSensors();
+  testBusErrors();
+  testModeAndRate();
+  testSensorLimits();
+  testGroupPeriod();
+  testFifo();
+  testFrameRoundTrip();
+  testReadEvents();
+  testAutoSleep();
+  testAsyncRead();
+  testMagMinMax();
+  testDisabledSensorEvents();
+  testFusion();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}